@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+struct Result;
+
+/*
+ * Day 5 almanac lookups for callers with far more seeds than the puzzle input holds. The stages
+ * are composed once into a single piecewise linear map from seed to location, a sorted breakpoint
+ * array small enough to stay in cache, and batches of seeds are located with a branchless search
+ * that the vector kernels run on several seeds at once, split across the worker threads. The stage
+ * at a time range mapping is kept as a variant of the solver to check the composition against.
+ *
+ * For almanacs whose rules change a few at a time the Engine keeps the answer up to date without
+ * recomposing. Each stage holds its rules in a balanced map by source and, as a step function, how
+ * many seeds reach each value of the stage. Moving a rule only changes where the seeds under its
+ * source interval go, so an edit takes the seeds counted there, sends them on through the later
+ * stages with the old function at -count and the new one at +count, and the lowest location is the
+ * first value counted after the last stage. An edit costs O(log rules) per step of the counts it
+ * touches rather than a pass over every rule. The rules of a stage must not overlap.
+ */
+namespace almanac
+{
+	/**
+	 * @brief every stage composed into one function from seed to location. Piece i covers [starts[i], starts[i + 1])
+	 *        (the last piece runs to the end of the values) and maps a value to value + offsets[i].
+	 *        Offsets are modulo 2^64 so pieces that map downwards hold the wrapped difference
+	 */
+	struct Composed_Map
+	{
+		std::vector<uint64_t> starts;	/** < ascending, starts[0] is 0 */
+		std::vector<uint64_t> offsets;
+	};
+
+	//compose the stages of a day 5 puzzle input, the seeds line is ignored
+	extern Composed_Map build( std::string_view input );
+
+	//locations[i] is the location of seeds[i], returns the lowest location or UINT64_MAX when there are no seeds
+	extern uint64_t locate( const Composed_Map& map, const uint64_t* seeds, size_t count, uint64_t* locations );
+
+	//solve a day 5 input by mapping the seed ranges through each stage in turn, coalescing them after every stage.
+	//registered as a variant of the day 5 solver
+	extern Result solve_stage_ranges( std::string_view input );
+
+	struct Rule
+	{
+		uint64_t destination;
+		uint64_t source;
+		uint64_t range;
+	};
+
+	struct Stage
+	{
+		std::map<uint64_t, Rule> rules;			/** < by source, values no rule covers pass through unchanged */
+		std::map<uint64_t, int64_t> seeds;		/** < number of seeds reaching each value from a key to the next, the last key runs to the end */
+	};
+
+	struct Engine
+	{
+		std::vector<Stage> stages;
+		std::map<uint64_t, int64_t> locations;	/** < seeds reaching each location, as Stage::seeds */
+	};
+
+	//index a day 5 puzzle input, the seeds are read as part 1 values or as part 2 (start, length) ranges.
+	//throws std::invalid_argument if two rules of a stage overlap
+	extern Engine build_engine( std::string_view input, bool seed_ranges );
+
+	//add a rule to a stage, throws std::invalid_argument if the stage doesn't exist, the rule is empty or it overlaps a rule of the stage
+	extern void insert_rule( Engine& engine, size_t stage, const Rule& rule );
+
+	//remove the rule starting at source from a stage, throws std::invalid_argument if there is no such rule
+	extern void remove_rule( Engine& engine, size_t stage, uint64_t source );
+
+	//location of a single seed through the current rules, O(stages * log rules)
+	extern uint64_t lookup( const Engine& engine, uint64_t seed );
+
+	//lowest location of any seed, UINT64_MAX when there are no seeds
+	extern uint64_t lowest_location( const Engine& engine );
+
+	//solve a day 5 input with one engine for each part, registered as a variant of the day 5 solver
+	extern Result solve_engine( std::string_view input );
+}
@@ -0,0 +1,98 @@
+#include "aoc.h"
+#include "aoc_c.h"
+#include "buffer.h"
+#include "cpu_dispatch.h"
+#include "days.h"
+#include "parallel.h"
+#include "result.h"
+
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static const std::vector< Result( * )( std::string_view ) > s_days = { aoc::day_01, aoc::day_02, aoc::day_03, aoc::day_04, aoc::day_05, aoc::day_06,
+																		 aoc::day_07, aoc::day_08, aoc::day_09, aoc::day_10, aoc::day_11, aoc::day_12,
+																		 aoc::day_13, aoc::day_14, aoc::day_15, aoc::day_16, aoc::day_17, aoc::day_18,
+																		 aoc::day_19, aoc::day_20 };
+
+//the C status codes are the C++ ones passed straight through
+static_assert( static_cast<int>(aoc::Status::unknown_day) == AOC_UNKNOWN_DAY && static_cast<int>(aoc::Status::unsupported_isa) == AOC_UNSUPPORTED_ISA
+			   && static_cast<int>(aoc::Status::invalid_input) == AOC_INVALID_INPUT );
+
+aoc::Status aoc::solve( const uint32_t day, const char* input, const size_t size, const Options& options, Answer& answer )
+{
+	if ( day == 0 || day > s_days.size() )
+	{
+		return Status::unknown_day;
+	}
+	if ( !options.isa.empty() )
+	{
+		cpu::Isa isa = {};
+		if ( !cpu::parse_isa( options.isa, isa ) || !cpu::select( isa ) )
+		{
+			return Status::unsupported_isa;
+		}
+	}
+	if ( options.threads != 0 )
+	{
+		parallel::set_thread_count( options.threads );
+	}
+	//the parsers expect at least one line of input
+	if ( input == nullptr || size == 0 )
+	{
+		return Status::invalid_input;
+	}
+	try
+	{
+		std::string normalised = {};
+		const Result result = s_days[day - 1]( buffer::normalise_line_ends( std::string_view( input, size ), normalised ) );
+		answer = { result.name, result.part_1, result.part_2, result.execution_time };
+	}
+	catch ( const std::exception& )
+	{
+		return Status::invalid_input;
+	}
+	return Status::ok;
+}
+
+const char* aoc::status_name( const Status status )
+{
+	switch ( status )
+	{
+	case Status::ok: return "ok";
+	case Status::unknown_day: return "unknown day";
+	case Status::unsupported_isa: return "unsupported instruction set";
+	default: return "invalid input";
+	}
+}
+
+aoc_status aoc_solve( const uint32_t day, const char* input, const size_t size, const aoc_options* options, aoc_answer* answer )
+{
+	if ( answer == nullptr )
+	{
+		return AOC_INVALID_INPUT;
+	}
+	aoc::Answer result = {};
+	//nothing may escape into C, a bad_alloc from copying the options is reported like any other failure
+	try
+	{
+		const aoc::Options cpp_options = { (options != nullptr && options->isa != nullptr) ? options->isa : "", (options != nullptr) ? options->threads : 0 };
+		const aoc::Status status = aoc::solve( day, input, size, cpp_options, result );
+		if ( status != aoc::Status::ok )
+		{
+			return static_cast<aoc_status>(status);
+		}
+	}
+	catch ( const std::exception& )
+	{
+		return AOC_INVALID_INPUT;
+	}
+	*answer = { result.part_1, result.part_2, result.execution_time };
+	return AOC_OK;
+}
+
+const char* aoc_status_name( const aoc_status status )
+{
+	return aoc::status_name( static_cast<aoc::Status>(status) );
+}
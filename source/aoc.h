@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Entry point for embedding the solvers. Inputs are passed in memory, nothing is read from or
+ * written to disk and nothing is printed. The C interface in aoc_c.h wraps this one.
+ */
+namespace aoc
+{
+	constexpr uint32_t day_count = 20;
+
+	enum class Status : uint8_t
+	{
+		ok = 0,
+		unknown_day,		/** < day is not between 1 and day_count */
+		unsupported_isa,	/** < options.isa is unknown or not supported on this CPU */
+		invalid_input		/** < the input was empty or could not be parsed */
+	};
+
+	struct Options
+	{
+		std::string isa;	/** < kernel instruction set, empty keeps the current one. Applies to the whole process */
+		uint32_t threads;	/** < threads for the parallel parts of the solvers, 0 keeps the current count. Applies to the whole process */
+	};
+
+	struct Answer
+	{
+		std::string name;
+		uint64_t part_1;
+		uint64_t part_2;
+		double execution_time;	/** < seconds spent parsing and solving both parts */
+	};
+
+	//solve day (1 based) from the puzzle input in [input, input + size), answer is only written when ok is returned
+	extern Status solve( uint32_t day, const char* input, size_t size, const Options& options, Answer& answer );
+
+	extern const char* status_name( Status status );
+}
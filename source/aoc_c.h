@@ -0,0 +1,41 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Plain C interface to the solvers, see aoc.h
+ */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	typedef enum aoc_status
+	{
+		AOC_OK = 0,
+		AOC_UNKNOWN_DAY = 1,
+		AOC_UNSUPPORTED_ISA = 2,
+		AOC_INVALID_INPUT = 3
+	} aoc_status;
+
+	typedef struct aoc_options
+	{
+		const char* isa;	/* kernel instruction set, NULL or "" keeps the current one */
+		uint32_t threads;	/* threads for the parallel parts of the solvers, 0 keeps the current count */
+	} aoc_options;
+
+	typedef struct aoc_answer
+	{
+		uint64_t part_1;
+		uint64_t part_2;
+		double execution_time;
+	} aoc_answer;
+
+	/* options may be NULL, answer is only written when AOC_OK is returned */
+	aoc_status aoc_solve( uint32_t day, const char* input, size_t size, const aoc_options* options, aoc_answer* answer );
+
+	const char* aoc_status_name( aoc_status status );
+
+#ifdef __cplusplus
+}
+#endif
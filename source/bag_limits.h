@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+ * What-if queries over a day 2 game log: for a bag holding at most (red, green, blue) cubes, the sum
+ * of the IDs of every game that could have been played with it. A game fits when its largest count of
+ * each colour is within the limit, so a query is a 3D dominance sum. The log is indexed once, sorted
+ * by red with green and blue reduced to ranks, then each batch of limits is answered offline by
+ * sweeping red and querying a 2D Fenwick tree over the (green, blue) ranks, O(log g * log b) per game
+ * and per query. The tree holds one entry per pair of distinct green and blue counts, tiny for cube
+ * counts but not meant for logs with millions of distinct values.
+ */
+namespace bag_limits
+{
+	struct Limit
+	{
+		uint32_t red;
+		uint32_t green;
+		uint32_t blue;
+	};
+
+	struct Game_Log
+	{
+		std::vector<uint32_t> red;			/** < largest red count of each game, ascending */
+		std::vector<uint32_t> green_rank;	/** < index of the game's largest green count in green_values */
+		std::vector<uint32_t> blue_rank;
+		std::vector<uint32_t> id;
+		std::vector<uint32_t> green_values;	/** < distinct green counts, ascending */
+		std::vector<uint32_t> blue_values;
+	};
+
+	//index the games of a day 2 puzzle input
+	extern Game_Log build( std::string_view input );
+
+	//sum of the IDs of the games that fit each limit, sums[i] answers limits[i]
+	extern std::vector<uint64_t> sum_fitting_ids( const Game_Log& log, const std::vector<Limit>& limits );
+}
@@ -0,0 +1,411 @@
+#include "batch.h"
+#include "parallel.h"
+#include "result.h"
+#include "solvers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define AOC_BATCH_PROCESSES 1
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#else
+#define AOC_BATCH_PROCESSES 0
+#endif
+
+namespace batch
+{
+	enum class Job_State : uint32_t
+	{
+		pending = 0,
+		claimed,
+		done,
+		failed,
+	};
+
+	struct Job
+	{
+		size_t day;		/** < index into the solver registry */
+		size_t input;	/** < index into the loaded inputs */
+	};
+
+	//one slot per job, written by whichever worker claimed the job
+	struct Job_Result
+	{
+		std::atomic<Job_State> state;
+		uint32_t worker;
+		uint64_t part_1;
+		uint64_t part_2;
+		double execution_time;
+	};
+
+	//the queue is a ticket counter over the fixed job list, claiming a job is a single fetch_add so workers never wait on each other.
+	//the atomics have to be address free for the table to be shared between processes
+	static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<Job_State>::is_always_lock_free);
+
+	//the queue counter gets a cache line of its own so claiming a job doesn't contend with results being written
+	constexpr size_t counter_bytes = 64;
+
+	struct Table
+	{
+		std::atomic<uint64_t>* next_job;
+		Job_Result* results;
+		void* memory;
+		size_t bytes;
+		bool shared;
+	};
+
+	struct Input
+	{
+		std::string name;
+		std::string contents;
+	};
+
+	static Table create_table( const size_t job_count, const bool shared )
+	{
+		Table table = {};
+		table.bytes = counter_bytes + sizeof( Job_Result ) * job_count;
+		table.shared = shared;
+#if AOC_BATCH_PROCESSES
+		if ( shared )
+		{
+			//anonymous shared mapping, the forked workers inherit it and write straight into the parent's table
+			table.memory = mmap( nullptr, table.bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+			if ( table.memory == MAP_FAILED )
+			{
+				throw std::bad_alloc();
+			}
+		}
+		else
+#endif
+		{
+			table.memory = ::operator new( table.bytes, std::align_val_t( counter_bytes ) );
+		}
+		table.next_job = new (table.memory) std::atomic<uint64_t>( 0 );
+		table.results = reinterpret_cast<Job_Result*>(static_cast<char*>(table.memory) + counter_bytes);
+		for ( size_t i = 0; i < job_count; ++i )
+		{
+			new (&table.results[i]) Job_Result{ { Job_State::pending }, 0, 0, 0, 0.0 };
+		}
+		return table;
+	}
+
+	static void destroy_table( Table& table )
+	{
+#if AOC_BATCH_PROCESSES
+		if ( table.shared )
+		{
+			munmap( table.memory, table.bytes );
+			return;
+		}
+#endif
+		::operator delete( table.memory, std::align_val_t( counter_bytes ) );
+	}
+
+	static void work( const std::vector<Job>& jobs, const std::vector<Input>& inputs, Table& table, const uint32_t worker )
+	{
+		const std::vector<solvers::Day>& registry = solvers::registry();
+		for ( uint64_t j = table.next_job->fetch_add( 1, std::memory_order_relaxed ); j < jobs.size(); j = table.next_job->fetch_add( 1, std::memory_order_relaxed ) )
+		{
+			Job_Result& slot = table.results[j];
+			slot.worker = worker;
+			slot.state.store( Job_State::claimed, std::memory_order_relaxed );
+			try
+			{
+				const Result result = registry[jobs[j].day].solve( inputs[jobs[j].input].contents );
+				slot.part_1 = result.part_1;
+				slot.part_2 = result.part_2;
+				slot.execution_time = result.execution_time;
+				slot.state.store( Job_State::done, std::memory_order_release );
+			}
+			catch ( const std::exception& )
+			{
+				slot.state.store( Job_State::failed, std::memory_order_release );
+			}
+		}
+	}
+
+	static void run_threads( const std::vector<Job>& jobs, const std::vector<Input>& inputs, Table& table, const uint32_t workers )
+	{
+		std::vector<std::thread> threads = {};
+		for ( uint32_t w = 1; w < workers; ++w )
+		{
+			threads.emplace_back( [&jobs, &inputs, &table, w]() { work( jobs, inputs, table, w ); } );
+		}
+		work( jobs, inputs, table, 0 );
+		for ( auto& thread : threads )
+		{
+			thread.join();
+		}
+	}
+
+#if AOC_BATCH_PROCESSES
+	bool processes_supported()
+	{
+		return true;
+	}
+
+	//worker w gets every workers'th cpu the parent may run on, so the workers split the machine between them
+	static void pin_worker( const uint32_t worker, const uint32_t workers )
+	{
+#if defined(__linux__)
+		cpu_set_t allowed = {};
+		if ( sched_getaffinity( 0, sizeof( allowed ), &allowed ) != 0 )
+		{
+			return;
+		}
+		std::vector<int> cpus = {};
+		for ( int c = 0; c < CPU_SETSIZE; ++c )
+		{
+			if ( CPU_ISSET( c, &allowed ) )
+			{
+				cpus.push_back( c );
+			}
+		}
+		if ( cpus.empty() )
+		{
+			return;
+		}
+		cpu_set_t subset = {};
+		CPU_ZERO( &subset );
+		for ( size_t i = worker % cpus.size(); i < cpus.size(); i += workers )
+		{
+			CPU_SET( cpus[i], &subset );
+		}
+		sched_setaffinity( 0, sizeof( subset ), &subset );
+#else
+		(void)worker;
+		(void)workers;
+#endif
+	}
+
+	//returns false if a worker could not be started or did not exit cleanly, the jobs it claimed are left unfinished
+	static bool run_processes( const std::vector<Job>& jobs, const std::vector<Input>& inputs, Table& table, const uint32_t workers )
+	{
+		//anything still buffered would be written again by every child
+		std::cout.flush();
+		std::vector<pid_t> children = {};
+		bool all_ok = true;
+		for ( uint32_t w = 0; w < workers; ++w )
+		{
+			const pid_t pid = fork();
+			if ( pid == 0 )
+			{
+				pin_worker( w, workers );
+				work( jobs, inputs, table, w );
+				_exit( 0 );
+			}
+			if ( pid < 0 )
+			{
+				all_ok = false;
+				break;
+			}
+			children.push_back( pid );
+		}
+		for ( const pid_t child : children )
+		{
+			int status = {};
+			while ( waitpid( child, &status, 0 ) < 0 && errno == EINTR )
+			{
+			}
+			all_ok = all_ok && WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+		}
+		return all_ok;
+	}
+#else
+	bool processes_supported()
+	{
+		return false;
+	}
+
+	static bool run_processes( const std::vector<Job>&, const std::vector<Input>&, Table&, const uint32_t )
+	{
+		return false;
+	}
+#endif
+
+	bool parse_mode( const std::string& name, Mode& mode )
+	{
+		if ( name == "threads" ) { mode = Mode::threads; return true; }
+		if ( name == "processes" ) { mode = Mode::processes; return true; }
+		if ( name == "both" ) { mode = Mode::both; return true; }
+		return false;
+	}
+
+	static const char* mode_name( const Mode mode )
+	{
+		return (mode == Mode::processes) ? "processes" : "threads";
+	}
+
+	struct Batch_Summary
+	{
+		double wall_seconds;
+		double solve_seconds;	/** < sum of the solvers' own times */
+		uint32_t failed;
+		uint32_t inconsistent;	/** < repeats of the same input that gave different answers */
+	};
+
+	static Batch_Summary run_batch( const Mode mode, const std::vector<Job>& jobs, const std::vector<Input>& inputs, const uint32_t workers )
+	{
+		Table table = create_table( jobs.size(), mode == Mode::processes );
+		const auto begin = std::chrono::steady_clock::now();
+		bool workers_ok = true;
+		if ( mode == Mode::processes )
+		{
+			workers_ok = run_processes( jobs, inputs, table, workers );
+		}
+		else
+		{
+			run_threads( jobs, inputs, table, workers );
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		Batch_Summary summary = { std::chrono::duration<double>( end - begin ).count(), 0.0, 0, 0 };
+		std::vector<const Job_Result*> first_answer( inputs.size(), nullptr );
+		for ( size_t j = 0; j < jobs.size(); ++j )
+		{
+			const Job_Result& slot = table.results[j];
+			if ( slot.state.load( std::memory_order_acquire ) != Job_State::done )
+			{
+				++summary.failed;
+				continue;
+			}
+			summary.solve_seconds += slot.execution_time;
+			const Job_Result*& first = first_answer[jobs[j].input];
+			if ( first == nullptr )
+			{
+				first = &slot;
+			}
+			else if ( first->part_1 != slot.part_1 || first->part_2 != slot.part_2 )
+			{
+				++summary.inconsistent;
+			}
+		}
+		if ( !workers_ok && summary.failed == 0 )
+		{
+			++summary.failed;
+		}
+		destroy_table( table );
+		return summary;
+	}
+
+	static void print_summary( const std::string& label, const Mode mode, const size_t job_count, const uint32_t workers, const Batch_Summary& summary )
+	{
+		const double jobs_per_second = (summary.wall_seconds > 0.0) ? job_count / summary.wall_seconds : 0.0;
+		std::cout << std::left << std::setw( 8 ) << label << std::setw( 11 ) << mode_name( mode ) << std::right << std::setw( 8 ) << workers
+			<< std::setw( 8 ) << job_count << std::setw( 14 ) << summary.wall_seconds << std::setw( 14 ) << summary.solve_seconds
+			<< std::fixed << std::setprecision( 1 ) << std::setw( 12 ) << jobs_per_second << std::defaultfloat << std::setprecision( 6 );
+		if ( summary.failed > 0 || summary.inconsistent > 0 )
+		{
+			std::cout << "  " << summary.failed << " failed, " << summary.inconsistent << " inconsistent";
+		}
+		std::cout << std::endl;
+	}
+
+	bool run( const Batch_Options& options )
+	{
+		if ( options.mode != Mode::threads && !processes_supported() )
+		{
+			std::cout << "Worker processes are not supported on this platform" << std::endl;
+			return false;
+		}
+		const uint32_t workers = std::max( options.workers, 1u );
+		const std::vector<solvers::Day>& registry = solvers::registry();
+
+		//collect the inputs in the parent, forked workers see them through copy on write without reading any files
+		std::vector<std::filesystem::path> files = {};
+		std::error_code error = {};
+		for ( const auto& entry : std::filesystem::directory_iterator( options.input_directory, error ) )
+		{
+			if ( entry.is_regular_file() && entry.path().extension() == ".txt" )
+			{
+				files.push_back( entry.path() );
+			}
+		}
+		std::sort( files.begin(), files.end() );
+
+		//the solvers' own parallel sections would compete with the workers for the same cores
+		const uint32_t previous_thread_count = parallel::thread_count();
+		parallel::set_thread_count( 1 );
+
+		std::cout << std::left << std::setw( 8 ) << "Day" << std::setw( 11 ) << "Mode" << std::right << std::setw( 8 ) << "Workers"
+			<< std::setw( 8 ) << "Jobs" << std::setw( 14 ) << "Wall (s)" << std::setw( 14 ) << "Solve (s)" << std::setw( 12 ) << "Jobs/s" << std::endl;
+		bool all_ok = true;
+		size_t total_jobs = {};
+		for ( size_t d = 0; d < registry.size(); ++d )
+		{
+			const std::string& label = registry[d].label;
+			if ( !options.day.empty() && options.day != label )
+			{
+				continue;
+			}
+			std::vector<Input> inputs = {};
+			for ( const auto& file : files )
+			{
+				const std::string name = file.filename().string();
+				if ( name == label + ".txt" || name.starts_with( label + "_" ) )
+				{
+					std::string contents = {};
+					if ( solvers::read_input_file( file.string(), contents ) )
+					{
+						inputs.push_back( { name, contents } );
+					}
+				}
+			}
+			if ( inputs.empty() )
+			{
+				continue;
+			}
+			std::vector<Job> jobs = {};
+			for ( uint32_t r = 0; r < std::max( options.repeat, 1u ); ++r )
+			{
+				for ( size_t i = 0; i < inputs.size(); ++i )
+				{
+					jobs.push_back( { d, i } );
+				}
+			}
+			total_jobs += jobs.size();
+
+			Batch_Summary thread_summary = {};
+			Batch_Summary process_summary = {};
+			if ( options.mode != Mode::processes )
+			{
+				thread_summary = run_batch( Mode::threads, jobs, inputs, workers );
+				print_summary( label, Mode::threads, jobs.size(), workers, thread_summary );
+				all_ok = all_ok && thread_summary.failed == 0 && thread_summary.inconsistent == 0;
+			}
+			if ( options.mode != Mode::threads )
+			{
+				process_summary = run_batch( Mode::processes, jobs, inputs, workers );
+				print_summary( label, Mode::processes, jobs.size(), workers, process_summary );
+				all_ok = all_ok && process_summary.failed == 0 && process_summary.inconsistent == 0;
+			}
+			if ( options.mode == Mode::both && process_summary.wall_seconds > 0.0 )
+			{
+				std::cout << std::left << std::setw( 8 ) << label << std::right << "processes are " << std::fixed << std::setprecision( 2 )
+					<< thread_summary.wall_seconds / process_summary.wall_seconds << "x the speed of threads" << std::defaultfloat << std::setprecision( 6 ) << std::endl;
+			}
+		}
+		parallel::set_thread_count( previous_thread_count );
+		if ( total_jobs == 0 )
+		{
+			std::cout << "No day_XX inputs found in " << options.input_directory << std::endl;
+			return false;
+		}
+		return all_ok;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/*
+ * Batch runner for solving many inputs on one machine. Every (day, input) pair is a job, workers
+ * claim jobs from a shared lock free queue and write the answers into a shared results table that
+ * is aggregated once every worker has finished. Workers are either threads in this process or
+ * forked processes pinned to their own cores, the second sidesteps contention on the allocator and
+ * page tables in one address space, so running both on the same jobs shows which scales better.
+ */
+namespace batch
+{
+	enum class Mode : uint8_t
+	{
+		threads = 0,
+		processes,
+		both,		/** < run the jobs with threads then with processes and compare */
+	};
+
+	struct Batch_Options
+	{
+		std::string input_directory;	/** < every day_XX.txt and day_XX_*.txt in here is a job for that day */
+		uint32_t workers;
+		uint32_t repeat;				/** < each input is queued this many times */
+		Mode mode;
+		std::string day;				/** < only run this day_XX, empty for all */
+	};
+
+	//are forked worker processes supported on this platform
+	extern bool processes_supported();
+
+	//convert a name ("threads", "processes", "both") to a mode
+	extern bool parse_mode( const std::string& name, Mode& mode );
+
+	//run the jobs and print per day wall time and throughput, returns false if there were no jobs or any job failed
+	extern bool run( const Batch_Options& options );
+}
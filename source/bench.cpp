@@ -0,0 +1,122 @@
+#include "bench.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+static double time_batches( const bench::Benchmark& benchmark, const uint64_t batches )
+{
+	timer::start();
+	for ( uint64_t i = 0; i < batches; ++i )
+	{
+		benchmark.run_batch();
+	}
+	bench::clobber_memory();
+	timer::stop();
+	return timer::get_elapsed_seconds();
+}
+
+//s as a quoted json string, escaping quotes, backslashes and control characters
+static std::string json_string( const std::string& s )
+{
+	std::stringstream quoted;
+	quoted << '"';
+	for ( const char c : s )
+	{
+		switch ( c )
+		{
+		case '"': quoted << "\\\""; break;
+		case '\\': quoted << "\\\\"; break;
+		case '\n': quoted << "\\n"; break;
+		case '\r': quoted << "\\r"; break;
+		case '\t': quoted << "\\t"; break;
+		default:
+			if ( static_cast<unsigned char>(c) < 0x20 )
+			{
+				quoted << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast<int>(c) << std::dec;
+			}
+			else
+			{
+				quoted << c;
+			}
+		}
+	}
+	quoted << '"';
+	return quoted.str();
+}
+
+bench::Measurement bench::run( const Benchmark& benchmark, const double min_seconds, const uint32_t repetitions )
+{
+	//warm the caches and any lazily built state
+	benchmark.run_batch();
+
+	//grow the number of batches until a repetition takes at least min_seconds
+	uint64_t batches = 1;
+	for ( double elapsed = time_batches( benchmark, batches ); elapsed < min_seconds; elapsed = time_batches( benchmark, batches ) )
+	{
+		//aim a little past the target but never grow more than 10x in one step in case the first timing was noise
+		const double scale = (elapsed > 0.0) ? (min_seconds * 1.2) / elapsed : 10.0;
+		batches = std::max( batches + 1, static_cast<uint64_t>(static_cast<double>(batches) * std::min( scale, 10.0 )) );
+	}
+
+	std::vector<double> ns_per_iteration = {};
+	const uint64_t iterations = batches * benchmark.batch_size;
+	for ( uint32_t r = 0; r < std::max( repetitions, 1u ); ++r )
+	{
+		ns_per_iteration.push_back( time_batches( benchmark, batches ) * 1e9 / static_cast<double>(iterations) );
+	}
+	std::ranges::sort( ns_per_iteration );
+	return { benchmark.name, benchmark.batch_size, iterations, ns_per_iteration[ns_per_iteration.size() / 2],
+			 ns_per_iteration.front(), ns_per_iteration.back(), benchmark.label };
+}
+
+std::string bench::to_json( const std::vector<Measurement>& measurements, const std::string& isa_name )
+{
+	const std::time_t now = std::time( nullptr );
+	std::tm utc = {};
+#if defined(_MSC_VER)
+	gmtime_s( &utc, &now );
+#else
+	gmtime_r( &now, &utc );
+#endif
+	std::stringstream json;
+	json << "{\n";
+	json << "  \"context\": {\n";
+	json << "    \"date\": \"" << std::put_time( &utc, "%Y-%m-%dT%H:%M:%SZ" ) << "\",\n";
+	json << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#if defined(NDEBUG)
+	json << "    \"library_build_type\": \"release\",\n";
+#else
+	json << "    \"library_build_type\": \"debug\",\n";
+#endif
+	json << "    \"isa\": " << json_string( isa_name ) << "\n";
+	json << "  },\n";
+	json << "  \"benchmarks\": [\n";
+	for ( size_t i = 0; i < measurements.size(); ++i )
+	{
+		const Measurement& m = measurements[i];
+		json << "    {\n";
+		json << "      \"name\": " << json_string( m.name ) << ",\n";
+		json << "      \"run_name\": " << json_string( m.name ) << ",\n";
+		json << "      \"run_type\": \"iteration\",\n";
+		json << "      \"iterations\": " << m.iterations << ",\n";
+		json << "      \"real_time\": " << m.ns_per_iteration << ",\n";
+		json << "      \"cpu_time\": " << m.ns_per_iteration << ",\n";
+		json << "      \"time_unit\": \"ns\",\n";
+		json << "      \"min_time\": " << m.min_ns_per_iteration << ",\n";
+		json << "      \"max_time\": " << m.max_ns_per_iteration << ",\n";
+		json << "      \"batch_size\": " << m.batch_size << ",\n";
+		if ( !m.label.empty() )
+		{
+			json << "      \"label\": " << json_string( m.label ) << ",\n";
+		}
+		json << "      \"items_per_second\": " << ((m.ns_per_iteration > 0.0) ? 1e9 / m.ns_per_iteration : 0.0) << "\n";
+		json << "    }" << ((i + 1 < measurements.size()) ? "," : "") << "\n";
+	}
+	json << "  ]\n";
+	json << "}\n";
+	return json.str();
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/*
+ * Microbenchmark harness for the hot kernels of each day. Each day that has kernels worth measuring
+ * provides a benchmarks::day_XX() function that generates input data and returns the benchmarks for
+ * that day, the bench target runs them in isolation and can write the results out as json.
+ */
+namespace bench
+{
+	/**
+	 * @brief a single kernel benchmark, run_batch calls the kernel batch_size times
+	 */
+	struct Benchmark
+	{
+		std::string name;					/** < reported name, day_XX::kernel/variant */
+		uint64_t batch_size;				/** < number of kernel calls made by one call to run_batch */
+		std::function<void()> run_batch;	/** < runs one batch against the generated data */
+		std::string label = {};				/** < optional note printed with the timings, such as sizes the kernel reached */
+	};
+
+	struct Measurement
+	{
+		std::string name;
+		uint64_t batch_size;
+		uint64_t iterations;		/** < kernel calls made in the measured repetition */
+		double ns_per_iteration;	/** < median over the repetitions */
+		double min_ns_per_iteration;
+		double max_ns_per_iteration;
+		std::string label = {};
+	};
+
+	//keep the compiler from optimising away a value that is otherwise unused
+	template <typename T>
+	inline void do_not_optimize( T const& value )
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		//no inline asm on x64 MSVC, escaping the address through a volatile makes the value observable
+		static const volatile void* sink = nullptr;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile( "" : : "m"(value) : "memory" );
+#endif
+	}
+
+	//force any pending writes to memory to be treated as observable
+	inline void clobber_memory()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		_ReadWriteBarrier();
+#else
+		asm volatile( "" : : : "memory" );
+#endif
+	}
+
+	//calibrate the number of batches to run for at least min_seconds then time the requested repetitions
+	extern Measurement run( const Benchmark& benchmark, double min_seconds, uint32_t repetitions );
+
+	//google benchmark compatible json so results can be compared between runs with the usual tooling
+	extern std::string to_json( const std::vector<Measurement>& measurements, const std::string& isa_name );
+}
+
+namespace benchmarks
+{
+	extern std::vector<bench::Benchmark> day_01();
+	extern std::vector<bench::Benchmark> day_02();
+	extern std::vector<bench::Benchmark> day_05();
+	extern std::vector<bench::Benchmark> day_06();
+	extern std::vector<bench::Benchmark> day_12();
+	extern std::vector<bench::Benchmark> day_14();
+	extern std::vector<bench::Benchmark> day_15();
+	extern std::vector<bench::Benchmark> day_16();
+	extern std::vector<bench::Benchmark> day_17();
+	extern std::vector<bench::Benchmark> day_19();
+	extern std::vector<bench::Benchmark> day_20();
+}
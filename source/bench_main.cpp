@@ -0,0 +1,99 @@
+//\==============================================================================
+// Microbenchmarks for the hot kernels of each day, run on generated data.
+// Usage: aoc_2023_bench [--filter=text] [--min-time=seconds] [--repetitions=n] [--json=file] [--isa=name] [--threads=n]
+//\==============================================================================
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "cpu_dispatch.h"
+#include "parallel.h"
+
+std::vector< std::vector<bench::Benchmark>( * )() > suites = { benchmarks::day_01, benchmarks::day_02, benchmarks::day_05, benchmarks::day_06, benchmarks::day_12, benchmarks::day_14,
+																benchmarks::day_15, benchmarks::day_16, benchmarks::day_17, benchmarks::day_19, benchmarks::day_20 };
+
+int main( int argc, char* argv[] )
+{
+	std::string filter = {};
+	std::string json_file = {};
+	double min_seconds = 0.1;
+	uint32_t repetitions = 5;
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		const std::string argument = argv[i];
+		if ( argument.starts_with( "--filter=" ) )
+		{
+			filter = argument.substr( 9 );
+		}
+		else if ( argument.starts_with( "--min-time=" ) )
+		{
+			min_seconds = std::stod( argument.substr( 11 ) );
+		}
+		else if ( argument.starts_with( "--repetitions=" ) )
+		{
+			repetitions = static_cast<uint32_t>(std::stoul( argument.substr( 14 ) ));
+		}
+		else if ( argument.starts_with( "--json=" ) )
+		{
+			json_file = argument.substr( 7 );
+		}
+		else if ( argument.starts_with( "--isa=" ) )
+		{
+			cpu::Isa isa = {};
+			if ( !cpu::parse_isa( argument.substr( 6 ), isa ) || !cpu::select( isa ) )
+			{
+				std::cout << "Instruction set '" << argument.substr( 6 ) << "' is unknown or not supported on this CPU" << std::endl;
+				return 1;
+			}
+		}
+		else if ( argument.starts_with( "--threads=" ) )
+		{
+			parallel::set_thread_count( static_cast<uint32_t>(std::stoul( argument.substr( 10 ) )) );
+		}
+		else
+		{
+			std::cout << "Unknown argument '" << argument << "'" << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "Kernels: " << cpu::isa_name( cpu::active_isa() ) << ", threads: " << parallel::thread_count() << std::endl;
+	std::cout << std::left << std::setw( 48 ) << "Benchmark" << std::right << std::setw( 8 ) << "Batch" << std::setw( 14 ) << "Iterations"
+		<< std::setw( 14 ) << "ns/iter" << std::setw( 14 ) << "min" << std::setw( 14 ) << "max" << std::setw( 14 ) << "items/s" << std::endl;
+
+	std::vector<bench::Measurement> measurements = {};
+	for ( const auto& suite : suites )
+	{
+		for ( const auto& benchmark : suite() )
+		{
+			if ( !filter.empty() && benchmark.name.find( filter ) == std::string::npos )
+			{
+				continue;
+			}
+			const bench::Measurement m = bench::run( benchmark, min_seconds, repetitions );
+			std::cout << std::left << std::setw( 48 ) << m.name << std::right << std::setw( 8 ) << m.batch_size << std::setw( 14 ) << m.iterations
+				<< std::fixed << std::setprecision( 2 ) << std::setw( 14 ) << m.ns_per_iteration << std::setw( 14 ) << m.min_ns_per_iteration
+				<< std::setw( 14 ) << m.max_ns_per_iteration << std::defaultfloat << std::setprecision( 4 ) << std::setw( 14 ) << ((m.ns_per_iteration > 0.0) ? 1e9 / m.ns_per_iteration : 0.0)
+				<< std::setprecision( 6 ) << (m.label.empty() ? "" : "  ") << m.label << std::endl;
+			measurements.push_back( m );
+		}
+	}
+
+	if ( !json_file.empty() )
+	{
+		std::ofstream file_output( json_file );
+		if ( !file_output.is_open() )
+		{
+			std::cout << "Unable to write " << json_file << std::endl;
+			return 1;
+		}
+		file_output << bench::to_json( measurements, cpu::isa_name( cpu::active_isa() ) );
+		file_output.close();
+	}
+	return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Day 6 races in bulk. Holding the button for h of a race's t milliseconds travels h * (t - h), which
+ * beats the record d for every h with (2h - t)^2 <= t^2 - 4(d + 1), so a race is counted from a single
+ * integer square root. The root is taken with 128 bit intermediates and settled on exact squares, so
+ * any 64 bit time and record is answered without the rounding of a floating point root. Times and
+ * records are passed as separate arrays, the vector kernels solve the races whose square fits in a
+ * double's mantissa several at a time and the rest take the integer root one by one.
+ */
+namespace boat_races
+{
+	//wins[i] is the number of ways to beat distances[i] in a race lasting times[i], split across the worker threads
+	extern void count_wins( const uint64_t* times, const uint64_t* distances, size_t count, uint64_t* wins );
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+/*
+ * Read only input stream over a puzzle input held in memory. The parsers were written against
+ * std::ifstream + std::getline, this lets them keep doing that on a caller owned buffer without
+ * copying it into a std::stringstream first. Inputs are read in binary, so "\r\n" line ends are
+ * turned into '\n' once on the way in and every parser only has to split on '\n'.
+ */
+namespace buffer
+{
+	//turn "\r\n" line ends into '\n' in place. A '\r' ending the last line is dropped, leaving a last line without a line
+	//end the parsers already accept, a lone '\r' anywhere else is kept
+	inline void normalise_line_ends( std::string& text )
+	{
+		size_t length = {};
+		for ( size_t i = 0; i < text.size(); ++i )
+		{
+			if ( text[i] != '\r' || (i + 1 < text.size() && text[i + 1] != '\n') )
+			{
+				text[length++] = text[i];
+			}
+		}
+		text.resize( length );
+	}
+
+	//text with '\n' line ends, text itself when it has no '\r' otherwise a normalised copy held in storage
+	inline std::string_view normalise_line_ends( const std::string_view text, std::string& storage )
+	{
+		if ( text.find( '\r' ) == std::string_view::npos )
+		{
+			return text;
+		}
+		storage.assign( text );
+		normalise_line_ends( storage );
+		return storage;
+	}
+
+	class Streambuf : public std::streambuf
+	{
+	public:
+		explicit Streambuf( const std::string_view text )
+		{
+			//the get area is never written through, streambuf just wants non const pointers
+			char* begin = const_cast<char*>(text.data());
+			setg( begin, begin, begin + text.size() );
+		}
+	};
+
+	//the streambuf is a base rather than a member so that it is constructed before std::istream is handed a pointer to it
+	class Stream : private Streambuf, public std::istream
+	{
+	public:
+		explicit Stream( const std::string_view text ) : Streambuf( text ), std::istream( static_cast<Streambuf*>(this) )
+		{
+		}
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "uint128.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <stdexcept>
+
+/*
+ * Day 4 part 2 over a stream of cards of any length. A card only wins copies of the cards just
+ * after it and can match at most max_matches numbers, so the copies still owed to the cards ahead
+ * are kept in a ring of that size as a difference array: a card adds its copies where its run of
+ * wins starts and takes them off where it ends. Each card is O(1) and memory is constant however
+ * many cards are read. Wins that would land past the last card are never collected. The count
+ * type is selectable, 64 bits for ordinary decks and wide::Uint128 for decks that would overflow.
+ */
+namespace card_stream
+{
+	//the card masks hold numbers 0 - 127 so no card matches more than this
+	constexpr size_t max_matches = 128;
+
+	template <typename Count>
+	struct Copies
+	{
+		std::array<Count, max_matches + 2> deltas;	/** < change in copies won at each card ahead, card n uses deltas[n % size] */
+		Count won;									/** < copies won by the current card from the cards before it */
+		Count total;								/** < every card so far including the won copies */
+		uint64_t card_count;
+	};
+
+	//add the next card of the stream and the number of its numbers that won
+	template <typename Count>
+	void push_card( Copies<Count>& copies, const uint32_t matches )
+	{
+		constexpr size_t ring_size = max_matches + 2;
+		if ( matches > max_matches )
+		{
+			throw std::invalid_argument( "a card can't match more than max_matches numbers" );
+		}
+		Count& delta = copies.deltas[copies.card_count % ring_size];
+		copies.won += delta;
+		delta = Count{};
+		//the original card plus every copy of it that was won
+		Count card_copies = copies.won;
+		card_copies += Count{ 1 };
+		copies.total += card_copies;
+		if ( matches > 0 )
+		{
+			copies.deltas[(copies.card_count + 1) % ring_size] += card_copies;
+			copies.deltas[(copies.card_count + 1 + matches) % ring_size] -= card_copies;
+		}
+		++copies.card_count;
+	}
+
+	//read day 4 cards a line at a time and count the scratchcards won, throws std::invalid_argument on a number that doesn't fit the masks
+	extern uint64_t count_cards( std::istream& input );
+	extern wide::Uint128 count_cards_wide( std::istream& input );
+}
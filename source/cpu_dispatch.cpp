@@ -0,0 +1,164 @@
+#include "cpu_dispatch.h"
+#include "simd_kernels.h"
+
+#if AOC_X86_KERNELS
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if AOC_X86_KERNELS
+static void read_cpuid( const uint32_t leaf, const uint32_t sub_leaf, uint32_t registers[4] )
+{
+#if defined(_MSC_VER)
+	int values[4] = {};
+	__cpuidex( values, static_cast<int>(leaf), static_cast<int>(sub_leaf) );
+	for ( int i = 0; i < 4; ++i )
+	{
+		registers[i] = static_cast<uint32_t>(values[i]);
+	}
+#else
+	__cpuid_count( leaf, sub_leaf, registers[0], registers[1], registers[2], registers[3] );
+#endif
+}
+
+//XCR0 tells us which register states the operating system saves on a context switch
+static uint64_t read_xcr0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv( 0 );
+#else
+	uint32_t eax = {};
+	uint32_t edx = {};
+	__asm__ volatile( "xgetbv" : "=a"(eax), "=d"(edx) : "c"(0) );
+	return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+cpu::Isa cpu::detect()
+{
+#if AOC_X86_KERNELS
+	uint32_t registers[4] = {};
+	read_cpuid( 0, 0, registers );
+	const uint32_t max_leaf = registers[0];
+
+	read_cpuid( 1, 0, registers );
+	const bool has_sse42 = (registers[2] & (1u << 20)) != 0;
+	const bool has_popcnt = (registers[2] & (1u << 23)) != 0;
+	const bool has_osxsave = (registers[2] & (1u << 27)) != 0;
+	const bool has_avx = (registers[2] & (1u << 28)) != 0;
+	if ( !has_sse42 || !has_popcnt )
+	{
+		return Isa::scalar;
+	}
+	//the wide registers are only usable if the OS saves the ymm (and zmm) state
+	if ( !has_osxsave || !has_avx || max_leaf < 7 )
+	{
+		return Isa::sse42;
+	}
+	const uint64_t xcr0 = read_xcr0();
+	if ( (xcr0 & 0x6) != 0x6 )
+	{
+		return Isa::sse42;
+	}
+
+	read_cpuid( 7, 0, registers );
+	const bool has_avx2 = (registers[1] & (1u << 5)) != 0;
+	const bool has_bmi1 = (registers[1] & (1u << 3)) != 0;
+	const bool has_bmi2 = (registers[1] & (1u << 8)) != 0;
+	const bool has_avx512f = (registers[1] & (1u << 16)) != 0;
+	const bool has_avx512bw = (registers[1] & (1u << 30)) != 0;
+	const bool has_avx512vl = (registers[1] & (1u << 31)) != 0;
+	if ( !has_avx2 || !has_bmi1 || !has_bmi2 )
+	{
+		return Isa::sse42;
+	}
+	//opmask, zmm low and zmm high state bits
+	if ( has_avx512f && has_avx512bw && has_avx512vl && (xcr0 & 0xE6) == 0xE6 )
+	{
+		return Isa::avx512;
+	}
+	return Isa::avx2;
+#else
+	return Isa::scalar;
+#endif
+}
+
+static const cpu::Kernels* get_kernel_table( const cpu::Isa isa )
+{
+	switch ( isa )
+	{
+#if AOC_X86_KERNELS
+	case cpu::Isa::sse42: return &simd::sse42_kernels;
+	case cpu::Isa::avx2: return &simd::avx2_kernels;
+	case cpu::Isa::avx512: return &simd::avx512_kernels;
+#endif
+	default: return &simd::scalar_kernels;
+	}
+}
+
+//detection happens once during static initialisation, before main runs
+static const cpu::Isa s_detected_isa = cpu::detect();
+static cpu::Isa s_active_isa = s_detected_isa;
+static const cpu::Kernels* s_active_kernels = get_kernel_table( s_detected_isa );
+
+bool cpu::is_supported( const Isa isa )
+{
+	//the instruction sets are ordered so anything up to the detected set is available
+	return static_cast<uint8_t>(isa) <= static_cast<uint8_t>(s_detected_isa);
+}
+
+bool cpu::select( const Isa isa )
+{
+	if ( !is_supported( isa ) )
+	{
+		return false;
+	}
+	s_active_isa = isa;
+	s_active_kernels = get_kernel_table( isa );
+	return true;
+}
+
+cpu::Isa cpu::active_isa()
+{
+	return s_active_isa;
+}
+
+const cpu::Kernels& cpu::kernels()
+{
+	return *s_active_kernels;
+}
+
+const char* cpu::isa_name( const Isa isa )
+{
+	switch ( isa )
+	{
+	case Isa::sse42: return "sse4.2";
+	case Isa::avx2: return "avx2";
+	case Isa::avx512: return "avx512";
+	default: return "scalar";
+	}
+}
+
+bool cpu::parse_isa( const std::string& name, Isa& isa )
+{
+	const Isa all[] = { Isa::scalar, Isa::sse42, Isa::avx2, Isa::avx512 };
+	for ( const auto candidate : all )
+	{
+		if ( name == isa_name( candidate ) )
+		{
+			isa = candidate;
+			return true;
+		}
+	}
+	//accept the unpunctuated spelling too
+	if ( name == "sse42" )
+	{
+		isa = Isa::sse42;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Runtime CPU feature dispatch. The build targets generic x64 so the hot kernels are compiled
+ * for several instruction sets and the best supported set is picked once when the program starts.
+ * The selection can be overridden (--isa=) to benchmark each path on the same machine.
+ */
+namespace cpu
+{
+	enum class Isa : uint8_t
+	{
+		scalar = 0,
+		sse42,
+		avx2,
+		avx512,
+	};
+
+	//value returned by the search kernels when nothing is found, matches std::string::npos
+	constexpr size_t not_found = static_cast<size_t>(-1);
+
+	/**
+	 * @brief table of kernel entry points, one table exists per instruction set
+	 */
+	struct Kernels
+	{
+		size_t	 (*find_first_digit)( const char* data, size_t length );	/** < index of the first '0'-'9' character or not_found */
+		size_t	 (*find_last_digit)( const char* data, size_t length );		/** < index of the last '0'-'9' character or not_found */
+		void	 (*count_card_matches)( const uint64_t* winning, const uint64_t* have, size_t card_count, uint8_t* matches ); /** < matches[i] = bits set in both 128 bit masks of card i, a card's mask is two words */
+		uint8_t	 (*holiday_hash)( const char* data, size_t length );		/** < day 15 HASH of a 7 bit ascii string */
+		bool	 (*rows_equal)( const char* a, const char* b, size_t length );	/** < byte compare of two equal length rows */
+		void	 (*classify_structure)( const char* data, size_t length, uint64_t* newline_bits, uint64_t* structural_bits ); /** < bit i of each of the (length + 63) / 64 words is set for '\n' / any of ":|({>" at data[i] */
+		uint64_t (*calibration_sum)( const char* data, size_t length );		/** < sum of 10 * first digit + last digit of every '\n' separated line, lines without a digit add 0 */
+		void	 (*piecewise_lookup)( const uint64_t* starts, const uint64_t* offsets, size_t piece_count, const uint64_t* values, size_t value_count, uint64_t* results ); /** < results[i] = values[i] + offsets[p] for the last p with starts[p] <= values[i], starts ascends from 0 */
+		void	 (*race_wins)( const uint64_t* times, const uint64_t* distances, size_t count, uint64_t* wins );	/** < wins[i] = number of h in [0, times[i]] with h * (times[i] - h) > distances[i], exact for any 64 bit values */
+	};
+
+	//detect the best instruction set supported by this CPU and operating system
+	extern Isa detect();
+
+	//is the instruction set available on this machine
+	extern bool is_supported( Isa isa );
+
+	//select the kernels for an instruction set, returns false if the CPU does not support it
+	extern bool select( Isa isa );
+
+	//the instruction set the active kernels were compiled for
+	extern Isa active_isa();
+
+	//the active kernel table
+	extern const Kernels& kernels();
+
+	extern const char* isa_name( Isa isa );
+
+	//convert a name ("scalar", "sse4.2", "avx2", "avx512") to an instruction set
+	extern bool parse_isa( const std::string& name, Isa& isa );
+}
@@ -6,15 +6,23 @@
 //\==============================================================================
 
 
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "cpu_dispatch.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
+#include <array>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /*
@@ -26,100 +34,362 @@
 namespace day_01
 {
 	/**
-	/* @brief a function to read input from file and store each input line as a string in a vector
-	 * @param input_file the directory path and name of the file to read from
-	*/
-	std::vector<std::string> read_input_from_file( const std::string& input_file )
+	 * @brief function to solve part 1 of the problem for day 1.
+	 *        Solution requires finding the first and last digit in each line
+	 *        and adding these to a running total 
+	 * @param input the raw puzzle input, scanned a block at a time without splitting it into lines
+	 * @return the sum total of all combined first & last digits in the input
+	 */
+	uint64_t part_1( const std::string_view input )
+	{
+		//the kernel builds digit and newline masks for each block and accumulates 10 * first + last as each line ends
+		return cpu::kernels().calibration_sum( input.data(), input.size() );
+	}
+
+	constexpr std::array<std::string_view, 9> digit_words = { "one", "two", "three", "four", "five", "six", "seven", "eight", "nine" };
+
+	/**
+	 * @brief Aho-Corasick automaton over the digit words and the digits '0'..'9' with every failure link folded into the
+	 *        transition table, so each input byte costs one table lookup. Bytes that can't appear in a pattern share a class
+	 *        that always returns to the root.
+	 */
+	struct Digit_Automaton
+	{
+		static constexpr size_t max_states = 64;
+		static constexpr size_t max_classes = 32;
+		static constexpr uint8_t no_digit = 0xFF;
+		std::array<uint8_t, 256> byte_class;
+		std::array<std::array<uint8_t, max_classes>, max_states> next;
+		std::array<uint8_t, max_states> digit;		/** < value of the pattern that ends in this state, no_digit for none */
+	};
+
+	/**
+	 * @brief build the automaton at compile time, the reversed automaton matches the patterns spelled backwards
+	 *        so that scanning a line from its end finds the last digit first
+	 */
+	constexpr Digit_Automaton build_digit_automaton( const bool reversed )
 	{
-		std::vector<std::string> input_vector = {};
-		//open the input file for reading
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		Digit_Automaton automaton = {};
+		automaton.digit.fill( Digit_Automaton::no_digit );
+		//the words are the values 1..9 and the digits 0..9, matching the digits part 1 accepts
+		std::array<std::string, 19> patterns = {};
+		std::array<uint8_t, 19> values = {};
+		for ( size_t i = 0; i < digit_words.size(); ++i )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			patterns[i] = std::string( digit_words[i] );
+			if ( reversed )
 			{
-				if ( line.length() > 0 )
+				std::reverse( patterns[i].begin(), patterns[i].end() );
+			}
+			values[i] = static_cast<uint8_t>(i + 1);
+		}
+		for ( size_t i = 0; i < 10; ++i )
+		{
+			patterns[digit_words.size() + i] = std::string( 1, static_cast<char>('0' + i) );
+			values[digit_words.size() + i] = static_cast<uint8_t>(i);
+		}
+		//class 0 is every byte that doesn't appear in a pattern
+		uint8_t class_count = 1;
+		for ( const auto& pattern : patterns )
+		{
+			for ( const char c : pattern )
+			{
+				uint8_t& byte_class = automaton.byte_class[static_cast<uint8_t>(c)];
+				if ( byte_class == 0 )
 				{
-					input_vector.push_back( line );
+					byte_class = class_count++;
 				}
-
 			}
-			file_input.close();
 		}
-		return input_vector;
+		//trie of the patterns, 0 in the table marks a missing edge until the failure links fill it in
+		std::array<uint8_t, Digit_Automaton::max_states> fail = {};
+		uint8_t state_count = 1;
+		for ( size_t p = 0; p < patterns.size(); ++p )
+		{
+			uint8_t state = 0;
+			for ( const char c : patterns[p] )
+			{
+				uint8_t& next = automaton.next[state][automaton.byte_class[static_cast<uint8_t>(c)]];
+				if ( next == 0 )
+				{
+					next = state_count++;
+				}
+				state = next;
+			}
+			automaton.digit[state] = values[p];
+		}
+		//breadth first so a state's failure target is complete before its children are visited
+		std::array<uint8_t, Digit_Automaton::max_states> queue = {};
+		size_t head = 0;
+		size_t tail = 0;
+		for ( uint8_t c = 0; c < class_count; ++c )
+		{
+			if ( automaton.next[0][c] != 0 )
+			{
+				queue[tail++] = automaton.next[0][c];
+			}
+		}
+		while ( head < tail )
+		{
+			const uint8_t state = queue[head++];
+			for ( uint8_t c = 0; c < class_count; ++c )
+			{
+				uint8_t& next = automaton.next[state][c];
+				if ( next != 0 )
+				{
+					fail[next] = automaton.next[fail[state]][c];
+					//a pattern that ends inside a longer one is still a match
+					if ( automaton.digit[next] == Digit_Automaton::no_digit )
+					{
+						automaton.digit[next] = automaton.digit[fail[next]];
+					}
+					queue[tail++] = next;
+				}
+				else
+				{
+					next = automaton.next[fail[state]][c];
+				}
+			}
+		}
+		return automaton;
 	}
 
+	constexpr Digit_Automaton forward_automaton = build_digit_automaton( false );
+	constexpr Digit_Automaton backward_automaton = build_digit_automaton( true );
+
 	/**
-	 * @brief function to solve part 1 of the problem for day 1.
-	 *        Solution requires finding the first and last digit in the string
-	 *        and adding these to a running total 
-	 * @param input a vector of strings that contain numerical digits
-	 * @return the sum total of all combined first & last digits in the input string vector
+	 * @brief Function to solve part 2 of the question
+	 *        This time the input needs to be scanned for the written number values as well as the decimal values
+	 * @param input the raw puzzle input, read only so part 1 can run over the same data at the same time
+	 * @return the sum total of all combined first and last numbers found in each line of the input
 	 */
-	uint32_t part_1( std::vector<std::string>& input )
+	uint64_t part_2( const std::string_view input )
 	{
-		//keep track of the accumulated total for the calibration values
-		uint32_t calibration_value_sum = {};
-		uint32_t calibration_value = {};
-		const std::string digits = "0123456789";
-
-		for ( const auto& line : input )
+		uint64_t calibration_value_sum = {};
+		for ( size_t line_start = 0; line_start < input.size(); )
 		{
-			const size_t first = line.find_first_of( digits );		//find the first integer value in the string
-			const size_t last = line.find_last_of( digits );			//find the last integer value in the string
-
-			const std::string calibration_value_string = std::string( line, first, 1 ) + std::string( line, last, 1 );
-			std::stringstream ss( calibration_value_string );
-			ss >> calibration_value;
-			calibration_value_sum += calibration_value;
-			
+			size_t line_end = input.find( '\n', line_start );
+			if ( line_end == std::string_view::npos )
+			{
+				line_end = input.size();
+			}
+			//scan forward until the first match then backward from the end of the line until the last,
+			//overlapping words such as 'twone' are found by both automatons as their own digit
+			uint8_t state = 0;
+			size_t position = line_start;
+			for ( ; position < line_end && forward_automaton.digit[state] == Digit_Automaton::no_digit; ++position )
+			{
+				state = forward_automaton.next[state][forward_automaton.byte_class[static_cast<uint8_t>(input[position])]];
+			}
+			if ( forward_automaton.digit[state] != Digit_Automaton::no_digit )
+			{
+				const uint64_t first = forward_automaton.digit[state];
+				state = 0;
+				for ( position = line_end; backward_automaton.digit[state] == Digit_Automaton::no_digit; --position )
+				{
+					state = backward_automaton.next[state][backward_automaton.byte_class[static_cast<uint8_t>(input[position - 1])]];
+				}
+				calibration_value_sum += 10 * first + backward_automaton.digit[state];
+			}
+			line_start = line_end + 1;
 		}
 		return calibration_value_sum;
 	}
 
 	/**
-	 * @brief Function to solve part 2 of the question
-	 *        This time the input needs to be scanned for the written number values as well as the decimal values
-	 * @param input vector of strings that contain written and decimal number values
-	 * @return the sum total of all combined first and last numbers found in each input string from the input vector
+	 * @brief split the input into chunks that each end on a newline so every line is summed by exactly one chunk,
+	 *        inputs smaller than a couple of chunks are left whole as threads would only add overhead
+	 */
+	std::vector<std::string_view> split_chunks( const std::string_view input )
+	{
+		constexpr size_t min_chunk_size = 1 << 20;
+		const size_t chunk_count = parallel::chunk_count( input.size(), min_chunk_size );
+		const size_t chunk_size = input.size() / chunk_count;
+		std::vector<std::string_view> chunks = {};
+		for ( size_t chunk_start = 0; chunk_start < input.size(); )
+		{
+			size_t chunk_end = (chunks.size() + 1 == chunk_count) ? std::string_view::npos : input.find( '\n', chunk_start + chunk_size );
+			chunk_end = (chunk_end == std::string_view::npos) ? input.size() : chunk_end + 1;
+			chunks.push_back( input.substr( chunk_start, chunk_end - chunk_start ) );
+			chunk_start = chunk_end;
+		}
+		return chunks;
+	}
+
+	/**
+	 * @brief sum a part over every chunk on worker threads, each chunk's total is its own 64 bit slot so the threads share nothing
+	 */
+	uint64_t sum_chunks( const std::vector<std::string_view>& chunks, uint64_t( *part )(std::string_view) )
+	{
+		std::vector<uint64_t> sums( chunks.size(), 0 );
+		parallel::for_each_index( chunks.size(), [&]( const size_t i )
+								  {
+									  sums[i] = part( chunks[i] );
+								  } );
+		return std::accumulate( sums.begin(), sums.end(), 0LLU );
+	}
+
+	/**
+	 * @brief the solver as it was before part 1 moved onto the block kernel and part 2 onto the automatons,
+	 *        kept as the registry's reference so --check compares the rewrite against it
 	 */
-	uint32_t part_2( std::vector<std::string>& input )
+	namespace reference
 	{
-		//Two vectors one of number words, the other of number digits. The indices of these vectors match up 
-		const std::vector<std::string> search_strings = { "one", "two", "three", "four", "five", "six", "seven", "eight", "nine" };
-		const std::vector<char> search_values = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
-		//for each line in the input vector find number strings and swap their second character for a digital representation
-		//second digit is swapped for the case of where 'twone4one' is the input this will become 't2o1e4o1e' if the first
-		//character was modified this would be incorrectly modified to 'tw1ne41ne' giving an incorrect value.
-		for ( auto& line : input )
+		/**
+		/* @brief a function to read the puzzle input and store each input line as a string in a vector
+		 * @param input the puzzle input text
+		*/
+		std::vector<std::string> read_input( const std::string_view input )
+		{
+			std::vector<std::string> input_vector = {};
+			//read the input a line at a time
+			buffer::Stream input_stream( input );
+			if ( !input.empty() )
+			{
+				for ( std::string line; std::getline( input_stream, line ); )
+				{
+					if ( line.length() > 0 )
+					{
+						input_vector.push_back( line );
+					}
+
+				}
+			}
+			return input_vector;
+		}
+
+		/**
+		 * @brief find the first and last digit in each string and add these to a running total
+		 * @param input a vector of strings that contain numerical digits
+		 * @return the sum total of all combined first & last digits in the input string vector
+		 */
+		uint32_t part_1( std::vector<std::string>& input )
+		{
+			//keep track of the accumulated total for the calibration values
+			uint32_t calibration_value_sum = {};
+			uint32_t calibration_value = {};
+			const cpu::Kernels& kernels = cpu::kernels();
+
+			for ( const auto& line : input )
+			{
+				const size_t first = kernels.find_first_digit( line.data(), line.size() );	//find the first integer value in the string
+				const size_t last = kernels.find_last_digit( line.data(), line.size() );	//find the last integer value in the string
+
+				const std::string calibration_value_string = std::string( line, first, 1 ) + std::string( line, last, 1 );
+				std::stringstream ss( calibration_value_string );
+				ss >> calibration_value;
+				calibration_value_sum += calibration_value;
+			}
+			return calibration_value_sum;
+		}
+
+		/**
+		 * @brief scan the input for the written number values as well as the decimal values
+		 * @param input vector of strings that contain written and decimal number values
+		 * @return the sum total of all combined first and last numbers found in each input string from the input vector
+		 */
+		uint32_t part_2( std::vector<std::string>& input )
 		{
-			uint32_t index = 0;
-			for ( auto& number : search_strings )
+			//Two vectors one of number words, the other of number digits. The indices of these vectors match up 
+			const std::vector<std::string> search_strings = { "one", "two", "three", "four", "five", "six", "seven", "eight", "nine" };
+			const std::vector<char> search_values = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+			//for each line in the input vector find number strings and swap their second character for a digital representation
+			//second digit is swapped for the case of where 'twone4one' is the input this will become 't2o1e4o1e' if the first
+			//character was modified this would be incorrectly modified to 'tw1ne41ne' giving an incorrect value.
+			for ( auto& line : input )
 			{
-				size_t location = line.find( number );
-				while( location != std::string::npos )
+				uint32_t index = 0;
+				for ( auto& number : search_strings )
 				{
-					line[location+1] = search_values[index];
-					location = line.find( number, location+1 );
+					size_t location = line.find( number );
+					while( location != std::string::npos )
+					{
+						line[location+1] = search_values[index];
+						location = line.find( number, location+1 );
+					}
+					++index;
 				}
-				++index;
-			}			
+			}
+			//now that the string has been modified to contain the relevant digits just call part 1 to solve.
+			return part_1( input );
 		}
-		//now that the string has been modified to contain the relevant digits just call part 1 to solve.
-		return part_1(input );
 	}
 }
 
-Result aoc::day_01()
+Result aoc::day_01( const std::string_view input )
 {
 	timer::start();
-	//vector to store the total quantity of calories that an elf is carrying
-	std::vector< std::string > input_values = day_01::read_input_from_file( "./input/day_01.txt" );
+	//both parts read the input in place, the only parsing is finding where to split it between threads
+	profiler::set_phase( "parse" );
+	const std::vector<std::string_view> chunks = day_01::split_chunks( input );
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_calibration_values_sum = day_01::sum_chunks( chunks, day_01::part_1 );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_calibration_values_sum = day_01::sum_chunks( chunks, day_01::part_2 );
+	timer::stop();
 
-	const uint32_t part_1_calibration_values_sum = day_01::part_1( input_values );
-	const uint32_t part_2_calibration_values_sum = day_01::part_2( input_values );
+	return { std::string(" 1: Trebuchet?!"), part_1_calibration_values_sum, part_2_calibration_values_sum, timer::get_elapsed_seconds()};
+}
+
+Result references::day_01( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	std::vector< std::string > input_values = day_01::reference::read_input( input );
+
+	profiler::set_phase( "part_1" );
+	const uint32_t part_1_calibration_values_sum = day_01::reference::part_1( input_values );
+	profiler::set_phase( "part_2" );
+	const uint32_t part_2_calibration_values_sum = day_01::reference::part_2( input_values );
 	timer::stop();
 
 	return { std::string(" 1: Trebuchet?!"), part_1_calibration_values_sum, part_2_calibration_values_sum, timer::get_elapsed_seconds()};
 }
+
+std::vector<bench::Benchmark> benchmarks::day_01()
+{
+	std::mt19937 rng( 1 );
+	//a quarter of a million calibration lines, far larger than the caches so the scan is bound by memory bandwidth
+	std::string input = {};
+	constexpr uint64_t line_count = 1 << 18;
+	for ( uint64_t line = 0; line < line_count; ++line )
+	{
+		const uint32_t length = 8 + rng() % 48;
+		for ( uint32_t c = 0; c < length; ++c )
+		{
+			input += (rng() % 8 == 0) ? static_cast<char>('1' + rng() % 9) : static_cast<char>('a' + rng() % 26);
+		}
+		input += '\n';
+	}
+	return {
+		{ "day_01::part_1/256k_lines", line_count, [input]()
+		{
+			bench::do_not_optimize( day_01::part_1( input ) );
+		} },
+		{ "day_01::part_2/256k_lines", line_count, [input = std::move( input )]()
+		{
+			bench::do_not_optimize( day_01::part_2( input ) );
+		} },
+	};
+}
+
+std::string generators::day_01( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	const std::vector<std::string> words = { "one", "two", "three", "four", "five", "six", "seven", "eight", "nine" };
+	//lines of letters with spelled out and plain digits mixed in, every line holds at least one plain digit for part 1
+	std::stringstream ss;
+	for ( int line = 0; line < 1000; ++line )
+	{
+		std::string text( 1, static_cast<char>('1' + rng() % 9) );
+		const uint32_t pieces = 1 + rng() % 8;
+		for ( uint32_t p = 0; p < pieces; ++p )
+		{
+			const uint32_t kind = rng() % 3;
+			const std::string piece = (kind == 0) ? words[rng() % words.size()] : (kind == 1) ? std::string( 1, static_cast<char>('1' + rng() % 9) ) : std::string( 1, static_cast<char>('a' + rng() % 26) );
+			text.insert( rng() % (text.size() + 1), piece );
+		}
+		ss << text << '\n';
+	}
+	return ss.str();
+}
\ No newline at end of file
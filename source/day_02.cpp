@@ -6,180 +6,412 @@
 //\==============================================================================
 
 
+#include "bag_limits.h"
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
+#include "structural.h"
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
 
 namespace day_02
 {
-	//a set contains a number of coloured rgb cubes
-	struct RGB_set
+	//only the largest count of each colour over a game's sets is ever needed, kept as one array per colour
+	//so both parts are straight reductions over contiguous values
+	struct Games
 	{
-		uint32_t r;
-		uint32_t g;
-		uint32_t b;
+		std::vector<uint32_t> id;
+		std::vector<uint32_t> max_r;
+		std::vector<uint32_t> max_g;
+		std::vector<uint32_t> max_b;
 	};
 
-	//a game is a number of sets with an ID
-	struct Game
+	/**
+	 * @brief parse every game in a single pass over the input, each count is followed by its colour and the colour's
+	 *        first byte is enough to tell them apart, sets don't need splitting as only the maximum per colour is kept
+	 */
+	Games read_input( const std::string_view input )
 	{
-		uint32_t id;
-		std::vector<RGB_set> sets;
-	};
-
-	uint32_t get_game_id_from_string( const std::string& input )
-	{
-		const std::string digits = "0123456789";
-		uint32_t game_id = {};
-		//find the first digit in the line then then ':' to get the game ID
-		size_t id_start = input.find_first_of( digits );
-		size_t id_end = input.find_first_of( ':' );
-		std::string game_string = std::string( input, id_start, id_end - id_start );
-		std::stringstream ss( game_string );
-		ss >> game_id;
-		return game_id;
-	}
-
-	std::vector<RGB_set> get_game_sets_from_string( const std::string& input )
-	{
-		std::vector<RGB_set> sets = {};
-		//split the string on the ';' symbol
-		std::string set_string{};
-		std::stringstream input_stream( input );
-		//split the input string on the ';' character
-		while ( std::getline( input_stream, set_string, ';' ) )
+		Games games = {};
+		for ( size_t line_start = 0; line_start < input.size(); )
 		{
-			RGB_set current_set = {};
-			//string is now in the format "# colour, # colour"
-			//split on ','
-			std::string count_colour_string{};
-			std::stringstream count_colour_stream( set_string );
-			while ( std::getline( count_colour_stream, count_colour_string, ',' ) )
+			size_t line_end = input.find( '\n', line_start );
+			if ( line_end == std::string_view::npos )
 			{
-				//string will be in format " # colour"
-				//strip any leading spaces
-				size_t start = input.find_first_of( "0123456789" );
-				uint32_t value = {};
-				std::string colour = {};
-				//use stream to get colour string and value
-				std::stringstream count_colour( count_colour_string.substr( start ) );
-				count_colour >> value;
-				count_colour >> colour;
-				if ( colour == "red" )
-				{
-					current_set.r = value;
-				}
-				else if ( colour == "blue" )
-				{
-					current_set.b = value;
-				}
-				else
+				line_end = input.size();
+			}
+			//the game ID is the number in front of the ':'
+			size_t i = line_start;
+			uint32_t id = {};
+			for ( ; i < line_end && input[i] != ':'; ++i )
+			{
+				if ( input[i] >= '0' && input[i] <= '9' )
 				{
-					current_set.g = value;
+					id = id * 10 + static_cast<uint32_t>(input[i] - '0');
 				}
 			}
-			sets.push_back( current_set );
-		}
-		return sets;
-	}
-
-	std::vector<Game> read_input_from_file( std::string filename )
-	{
-		std::vector<Game> games = {};
-		//open the input file for and parse into a vector of games
-		std::ifstream file_input;
-		file_input.open( filename );
-		if ( file_input.is_open() )
-		{
-			for ( std::string line; std::getline( file_input, line ); )
+			if ( i < line_end )
 			{
-				if ( line.length() > 0 )
+				uint32_t max_rgb[3] = {};
+				uint32_t value = {};
+				bool has_value = false;
+				for ( ++i; i < line_end; ++i )
 				{
-					//Get the games id from the line
-					const uint32_t game_id = get_game_id_from_string( line );
-					//get the number sets for this game
-					const size_t game_data_start = line.find_first_of( ':' ) + 1;
-					const std::vector<RGB_set> game_sets = get_game_sets_from_string( line.substr( game_data_start ) );
-					games.push_back( { game_id, game_sets } );
+					const char c = input[i];
+					if ( c >= '0' && c <= '9' )
+					{
+						value = value * 10 + static_cast<uint32_t>(c - '0');
+						has_value = true;
+					}
+					else if ( has_value && c >= 'a' && c <= 'z' )
+					{
+						//red and blue by their first letter, anything else counts as green
+						const size_t colour = (c == 'r') ? 0 : (c == 'b') ? 2 : 1;
+						max_rgb[colour] = std::max( max_rgb[colour], value );
+						value = 0;
+						has_value = false;
+					}
 				}
-
+				games.id.push_back( id );
+				games.max_r.push_back( max_rgb[0] );
+				games.max_g.push_back( max_rgb[1] );
+				games.max_b.push_back( max_rgb[2] );
 			}
-			//close the input file
-			file_input.close();
+			line_start = line_end + 1;
 		}
 		return games;
 	}
 
-	uint32_t part_1( const std::vector<Game>& games )
+	uint32_t part_1( const Games& games )
 	{
 		//bag is loaded with max 12 red, 13 green, 14 blue
 		constexpr uint32_t valid_red = 12;
 		constexpr uint32_t valid_green = 13;
 		constexpr uint32_t valid_blue = 14;
-		//games that contain fewer  cubes than these values are valid
+		//games that contain fewer cubes than these values are valid, branch free so the loop vectorises
 		uint32_t sum_valid_game_ids = {};
-		for ( const auto& game : games )
+		for ( size_t i = 0; i < games.id.size(); ++i )
+		{
+			const bool is_valid = (games.max_r[i] <= valid_red) & (games.max_g[i] <= valid_green) & (games.max_b[i] <= valid_blue);
+			sum_valid_game_ids += is_valid ? games.id[i] : 0;
+		}
+		return sum_valid_game_ids;
+	}
+
+	uint32_t part_2( const Games& games )
+	{
+		//the power of a game is the product of the fewest cubes of each colour that make it possible
+		uint32_t sum_game_power = {};
+		for ( size_t i = 0; i < games.id.size(); ++i )
 		{
-			bool is_valid = true;
-			for ( const auto& set : game.sets )
+			sum_game_power += games.max_r[i] * games.max_g[i] * games.max_b[i];
+		}
+		return sum_game_power;
+	}
+
+	/**
+	 * @brief the solver as it was before the one pass parse into per colour max arrays,
+	 *        kept as the registry's reference so --check compares the rewrite against it
+	 */
+	namespace reference
+	{
+		//a set contains a number of coloured rgb cubes
+		struct RGB_set
+		{
+			uint32_t r;
+			uint32_t g;
+			uint32_t b;
+		};
+
+		//a game is a number of sets with an ID
+		struct Game
+		{
+			uint32_t id;
+			std::vector<RGB_set> sets;
+		};
+
+		//input is the "Game #" text in front of the ':'
+		uint32_t get_game_id_from_string( const std::string_view input )
+		{
+			uint32_t game_id = {};
+			//find the first digit in the line to get the game ID
+			const size_t id_start = input.find_first_of( "0123456789" );
+			buffer::Stream ss( input.substr( id_start ) );
+			ss >> game_id;
+			return game_id;
+		}
+
+		std::vector<RGB_set> get_game_sets_from_string( const std::string& input )
+		{
+			std::vector<RGB_set> sets = {};
+			//split the string on the ';' symbol
+			std::string set_string{};
+			std::stringstream input_stream( input );
+			//split the input string on the ';' character
+			while ( std::getline( input_stream, set_string, ';' ) )
 			{
-				if ( set.r > valid_red ||
-					 set.g > valid_green ||
-					 set.b > valid_blue )
+				RGB_set current_set = {};
+				//string is now in the format "# colour, # colour"
+				//split on ','
+				std::string count_colour_string{};
+				std::stringstream count_colour_stream( set_string );
+				while ( std::getline( count_colour_stream, count_colour_string, ',' ) )
 				{
-					is_valid = false;
+					//string will be in format " # colour"
+					//strip any leading spaces
+					size_t start = input.find_first_of( "0123456789" );
+					uint32_t value = {};
+					std::string colour = {};
+					//use stream to get colour string and value
+					std::stringstream count_colour( count_colour_string.substr( start ) );
+					count_colour >> value;
+					count_colour >> colour;
+					if ( colour == "red" )
+					{
+						current_set.r = value;
+					}
+					else if ( colour == "blue" )
+					{
+						current_set.b = value;
+					}
+					else
+					{
+						current_set.g = value;
+					}
 				}
+				sets.push_back( current_set );
 			}
-			if ( is_valid )
+			return sets;
+		}
+
+		std::vector<Game> read_input( const std::string_view input )
+		{
+			std::vector<Game> games = {};
+			//read the input and parse into a vector of games
+			const structural::Index index = structural::build( input );
+			for ( size_t l = 0; l < structural::line_count( index ); ++l )
 			{
-				sum_valid_game_ids += game.id;
+				const std::string_view line = structural::line( index, l );
+				if ( line.length() > 0 )
+				{
+					//the index holds the ':' position, the game ID is in front of it and the sets follow it
+					const size_t colon_pos = structural::find_in_line( index, l );
+					const uint32_t game_id = get_game_id_from_string( line.substr( 0, colon_pos ) );
+					const std::vector<RGB_set> game_sets = get_game_sets_from_string( std::string( line.substr( colon_pos + 1 ) ) );
+					games.push_back( { game_id, game_sets } );
+				}
 			}
+			return games;
 		}
-		return sum_valid_game_ids;
-	}
 
-	uint32_t part_2( const std::vector<Game>& games )
-	{
-		//work out powers of each set based off min cubes needed from sets.
-		uint32_t sum_game_power = {};
-		for ( const auto& game : games )
+		uint32_t part_1( const std::vector<Game>& games )
 		{
-			uint32_t min_red = {};
-			uint32_t min_green = {};
-			uint32_t min_blue = {};
+			//bag is loaded with max 12 red, 13 green, 14 blue
+			constexpr uint32_t valid_red = 12;
+			constexpr uint32_t valid_green = 13;
+			constexpr uint32_t valid_blue = 14;
+			//games that contain fewer  cubes than these values are valid
+			uint32_t sum_valid_game_ids = {};
+			for ( const auto& game : games )
+			{
+				bool is_valid = true;
+				for ( const auto& set : game.sets )
+				{
+					if ( set.r > valid_red ||
+						 set.g > valid_green ||
+						 set.b > valid_blue )
+					{
+						is_valid = false;
+					}
+				}
+				if ( is_valid )
+				{
+					sum_valid_game_ids += game.id;
+				}
+			}
+			return sum_valid_game_ids;
+		}
 
-			for ( const auto& set : game.sets )
+		uint32_t part_2( const std::vector<Game>& games )
+		{
+			//work out powers of each set based off min cubes needed from sets.
+			uint32_t sum_game_power = {};
+			for ( const auto& game : games )
 			{
-				//find the min number of cubes of colour needed to validate the game
-				min_red = set.r > min_red ? set.r : min_red;
-				min_green = set.g > min_green ? set.g : min_green;
-				min_blue = set.b > min_blue ? set.b : min_blue;
+				uint32_t min_red = {};
+				uint32_t min_green = {};
+				uint32_t min_blue = {};
+
+				for ( const auto& set : game.sets )
+				{
+					//find the min number of cubes of colour needed to validate the game
+					min_red = set.r > min_red ? set.r : min_red;
+					min_green = set.g > min_green ? set.g : min_green;
+					min_blue = set.b > min_blue ? set.b : min_blue;
+				}
+
+				sum_game_power += min_red * min_green * min_blue;
 			}
+			return sum_game_power;
 
-			sum_game_power += min_red * min_green * min_blue;
 		}
-		return sum_game_power;
-
 	}
 }
 
 
-Result aoc::day_02()
+Result aoc::day_02( const std::string_view input )
 {
 	timer::start();
-	//read file input
-	const std::vector<day_02::Game> games = day_02::read_input_from_file( "./input/day_02.txt" );
+	profiler::set_phase( "parse" );
+	//read input
+	const day_02::Games games = day_02::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint32_t part_1_answer = day_02::part_1( games );
+	profiler::set_phase( "part_2" );
 	const uint32_t part_2_answer = day_02::part_2( games );
 	timer::stop();
 
 	return { std::string( " 2: Cubes in Bags" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
 }
+
+Result references::day_02( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	const std::vector<day_02::reference::Game> games = day_02::reference::read_input( input );
+
+	profiler::set_phase( "part_1" );
+	const uint32_t part_1_answer = day_02::reference::part_1( games );
+	profiler::set_phase( "part_2" );
+	const uint32_t part_2_answer = day_02::reference::part_2( games );
+	timer::stop();
+
+	return { std::string( " 2: Cubes in Bags" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+bag_limits::Game_Log bag_limits::build( const std::string_view input )
+{
+	const day_02::Games games = day_02::read_input( input );
+	Game_Log log = {};
+	//distinct green and blue counts, a game's rank is its position among them
+	log.green_values = games.max_g;
+	log.blue_values = games.max_b;
+	for ( auto* values : { &log.green_values, &log.blue_values } )
+	{
+		std::sort( values->begin(), values->end() );
+		values->erase( std::unique( values->begin(), values->end() ), values->end() );
+	}
+	std::vector<size_t> order( games.id.size() );
+	std::iota( order.begin(), order.end(), 0 );
+	std::sort( order.begin(), order.end(), [&games]( const size_t a, const size_t b ) { return games.max_r[a] < games.max_r[b]; } );
+	for ( const size_t i : order )
+	{
+		log.red.push_back( games.max_r[i] );
+		log.green_rank.push_back( static_cast<uint32_t>(std::lower_bound( log.green_values.begin(), log.green_values.end(), games.max_g[i] ) - log.green_values.begin()) );
+		log.blue_rank.push_back( static_cast<uint32_t>(std::lower_bound( log.blue_values.begin(), log.blue_values.end(), games.max_b[i] ) - log.blue_values.begin()) );
+		log.id.push_back( games.id[i] );
+	}
+	return log;
+}
+
+std::vector<uint64_t> bag_limits::sum_fitting_ids( const Game_Log& log, const std::vector<Limit>& limits )
+{
+	//answer the limits in order of red so each game is added to the tree once, as soon as its red count fits
+	std::vector<size_t> order( limits.size() );
+	std::iota( order.begin(), order.end(), 0 );
+	std::sort( order.begin(), order.end(), [&limits]( const size_t a, const size_t b ) { return limits[a].red < limits[b].red; } );
+
+	//1 based 2D Fenwick tree over (green rank, blue rank), node (g, b) sums the ids of a rectangle of ranks ending at it
+	const size_t width = log.blue_values.size() + 1;
+	std::vector<uint64_t> tree( (log.green_values.size() + 1) * width, 0 );
+	std::vector<uint64_t> sums( limits.size(), 0 );
+	size_t next_game = 0;
+	for ( const size_t q : order )
+	{
+		const Limit& limit = limits[q];
+		for ( ; next_game < log.red.size() && log.red[next_game] <= limit.red; ++next_game )
+		{
+			for ( size_t g = log.green_rank[next_game] + 1; g <= log.green_values.size(); g += g & (~g + 1) )
+			{
+				for ( size_t b = log.blue_rank[next_game] + 1; b <= log.blue_values.size(); b += b & (~b + 1) )
+				{
+					tree[g * width + b] += log.id[next_game];
+				}
+			}
+		}
+		//prefix over every rank whose count is within the limit
+		const size_t green_count = static_cast<size_t>(std::upper_bound( log.green_values.begin(), log.green_values.end(), limit.green ) - log.green_values.begin());
+		const size_t blue_count = static_cast<size_t>(std::upper_bound( log.blue_values.begin(), log.blue_values.end(), limit.blue ) - log.blue_values.begin());
+		uint64_t sum = {};
+		for ( size_t g = green_count; g > 0; g &= g - 1 )
+		{
+			for ( size_t b = blue_count; b > 0; b &= b - 1 )
+			{
+				sum += tree[g * width + b];
+			}
+		}
+		sums[q] = sum;
+	}
+	return sums;
+}
+
+std::vector<bench::Benchmark> benchmarks::day_02()
+{
+	std::mt19937 rng( 2 );
+	//a large game log with the puzzle's range of cube counts and a batch of random what-if limits against it
+	std::stringstream ss;
+	for ( int game = 1; game <= 100000; ++game )
+	{
+		ss << "Game " << game << ": " << 1 + rng() % 20 << " red, " << 1 + rng() % 20 << " green, " << 1 + rng() % 20 << " blue\n";
+	}
+	bag_limits::Game_Log log = bag_limits::build( ss.str() );
+	std::vector<bag_limits::Limit> limits( 1 << 20 );
+	for ( auto& limit : limits )
+	{
+		limit = { static_cast<uint32_t>(rng() % 24), static_cast<uint32_t>(rng() % 24), static_cast<uint32_t>(rng() % 24) };
+	}
+	const uint64_t batch_size = limits.size();
+	return {
+		{ "day_02::sum_fitting_ids/1m_limits", batch_size, [log = std::move( log ), limits = std::move( limits )]()
+		{
+			bench::do_not_optimize( bag_limits::sum_fitting_ids( log, limits ) );
+		} },
+	};
+}
+
+std::string generators::day_02( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	const char* colours[3] = { "red", "green", "blue" };
+	std::stringstream ss;
+	for ( int game = 1; game <= 100; ++game )
+	{
+		ss << "Game " << game << ":";
+		const uint32_t sets = 1 + rng() % 6;
+		for ( uint32_t s = 0; s < sets; ++s )
+		{
+			//each set shows one to three of the colours in any order
+			uint32_t order[3] = { 0, 1, 2 };
+			std::shuffle( std::begin( order ), std::end( order ), rng );
+			const uint32_t shown = 1 + rng() % 3;
+			for ( uint32_t c = 0; c < shown; ++c )
+			{
+				ss << ((c == 0) ? " " : ", ") << 1 + rng() % 20 << ' ' << colours[order[c]];
+			}
+			ss << ((s + 1 < sets) ? ";" : "");
+		}
+		ss << '\n';
+	}
+	return ss.str();
+}
\ No newline at end of file
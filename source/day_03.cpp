@@ -6,176 +6,503 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "schematic_window.h"
+#include "solvers.h"
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
 #include <numeric>
+#include <random>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace day_03
 {
 
-	std::vector<std::string> read_input_file( const std::string& input_file )
+	std::vector<std::string_view> read_input( const std::string_view input )
 	{
-		std::vector<std::string> schematic = {};
-		//open the input file for and parse into a vector of games
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		std::vector<std::string_view> schematic = {};
+		//the rows are views into the input, nothing is copied
+		for ( size_t line_start = 0; line_start < input.size(); )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			size_t line_end = input.find( '\n', line_start );
+			if ( line_end == std::string_view::npos )
 			{
-				if ( line.length() > 0 )
-				{
-					schematic.push_back( line );
-				}
+				line_end = input.size();
+			}
+			if ( line_end > line_start )
+			{
+				schematic.push_back( input.substr( line_start, line_end - line_start ) );
 			}
-			file_input.close();
+			line_start = line_end + 1;
 		}
 		return schematic;
 	}
 
-	struct Part
+	inline bool is_digit( const char c )
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline bool is_symbol( const char c )
+	{
+		return c != '.' && !is_digit( c );
+	}
+
+	//every cell of the schematic holds the slot of the part number covering it, so a symbol finds its neighbours
+	//with eight lookups instead of scanning the parts on three rows
+	struct Parts
 	{
-		uint32_t id;
-		uint32_t row;
-		uint32_t start;
-		uint32_t end;
+		static constexpr uint32_t no_part = UINT32_MAX;
+		size_t width;						/** < length of the longest row, shorter rows are padded with no_part */
+		std::vector<uint32_t> cell_part;	/** < row * width + column -> index into ids */
+		std::vector<uint32_t> ids;
 	};
 
-	std::vector<std::vector<Part>> extract_parts( const std::vector<std::string>& schematic )
+	Parts extract_parts( const std::span<const std::string_view> schematic )
 	{
-		std::vector<std::vector<Part>> parts = {};
+		Parts parts = {};
+		for ( const auto& row : schematic )
+		{
+			parts.width = std::max( parts.width, row.size() );
+		}
+		parts.cell_part.assign( schematic.size() * parts.width, Parts::no_part );
 		//iterate over all rows in the schematic extracting parts
-		for ( uint32_t row = 0; row < schematic.size(); ++row )
+		for ( size_t row = 0; row < schematic.size(); ++row )
 		{
-			std::vector<Part> row_parts = {};
-			//process each row string
-			const std::string& row_string = schematic[row];
-			size_t start_pos = row_string.find_first_of( "0123456789" );
-			while(  start_pos != std::string::npos )
+			const std::string_view row_string = schematic[row];
+			for ( size_t column = 0; column < row_string.size(); )
 			{
-				uint32_t id;
-				size_t end_pos = row_string.find_first_not_of( "0123456789", start_pos );
-				if( end_pos == std::string::npos )
+				if ( !is_digit( row_string[column] ) )
 				{
-					//found the end of the line so process from start to end as a part number
-					std::stringstream( row_string.substr( start_pos ) ) >> id;
-					end_pos = row_string.size();
+					++column;
+					continue;
 				}
-				else
+				//read the number and mark each of its cells with its slot
+				const uint32_t slot = static_cast<uint32_t>(parts.ids.size());
+				uint32_t id = {};
+				for ( ; column < row_string.size() && is_digit( row_string[column] ); ++column )
 				{
-					std::stringstream( row_string.substr( start_pos, end_pos - start_pos ) ) >> id;
+					id = id * 10 + static_cast<uint32_t>(row_string[column] - '0');
+					parts.cell_part[row * parts.width + column] = slot;
 				}
-				row_parts.push_back( {id, row, static_cast<uint32_t>(start_pos), static_cast<uint32_t>(end_pos-1)} );
-				start_pos = row_string.find_first_of("0123456789", end_pos );
+				parts.ids.push_back( id );
 			}
-			parts.push_back( row_parts );
 		}
 		return parts;
 	}
 
-	std::vector<uint32_t> get_parts_on_row_for_symbol_at_pos( const uint32_t pos, const int32_t row, const std::vector<std::vector<Part>>& parts )
+	struct Answers
 	{
-		std::vector<uint32_t> part_ids = {};
-		if ( row < 0 || row >= parts.size() )
-		{
-			return part_ids;
-		}
-		//scan the parts on this row to see if any are adjacent to the position passed in
-		const std::vector<Part> row_parts = parts[row];
-		for ( const auto& part : row_parts )
+		uint64_t part_number_sum;	/** < part 1 */
+		uint64_t gear_ratio_sum;	/** < part 2 */
+	};
+
+	/**
+	 * @brief one pass over the symbols answers both parts, every symbol adds the parts next to it
+	 *        and every '*' next to more than one part adds the product of their ids
+	 * @param first_row, end_row only the symbols on these rows are summed, the rows outside them are read for their parts
+	 */
+	Answers sum_symbol_neighbours( const std::span<const std::string_view> schematic, const Parts& parts, const size_t first_row, const size_t end_row )
+	{
+		Answers answers = {};
+		for ( size_t row = first_row; row < end_row; ++row )
 		{
-			
-			const uint32_t dist_to_start = (part.start > pos) ? part.start - pos : pos - part.start;
-			const uint32_t dist_to_end = (part.end > pos) ? part.end - pos : pos - part.end;
-			if ( dist_to_start <= 1 || dist_to_end <= 1 )
+			const std::string_view row_string = schematic[row];
+			for ( size_t column = 0; column < row_string.size(); ++column )
 			{
-				//part is adjacent to symbol
-				part_ids.push_back( part.id );
+				if ( !is_symbol( row_string[column] ) )
+				{
+					continue;
+				}
+				uint64_t id_sum = {};
+				uint64_t id_product = 1;
+				uint32_t part_count = {};
+				for ( size_t y = (row > 0) ? row - 1 : row; y <= row + 1 && y < schematic.size(); ++y )
+				{
+					//a part is a run of cells on one row so it can only repeat in the cell next to it
+					uint32_t previous_slot = Parts::no_part;
+					for ( size_t x = (column > 0) ? column - 1 : column; x <= column + 1 && x < parts.width; ++x )
+					{
+						const uint32_t slot = parts.cell_part[y * parts.width + x];
+						if ( slot != Parts::no_part && slot != previous_slot )
+						{
+							id_sum += parts.ids[slot];
+							id_product *= parts.ids[slot];
+							++part_count;
+						}
+						previous_slot = slot;
+					}
+				}
+				answers.part_number_sum += id_sum;
+				if ( row_string[column] == '*' && part_count > 1 )
+				{
+					answers.gear_ratio_sum += id_product;
+				}
 			}
 		}
-		return part_ids;
+		return answers;
 	}
 
-	uint32_t part_1(const std::vector<std::string>& schematic, const std::vector<std::vector<Part>>& parts )
+	/**
+	 * @brief split the rows into bands that are solved on separate threads, each band indexes its own rows plus one halo row
+	 *        either side of it. A band only sums the symbols on its own rows so every symbol is counted by exactly one band,
+	 *        a number on a band edge is added once for each symbol it touches whichever band that symbol is in, just as
+	 *        a single pass would
+	 */
+	Answers sum_bands( const std::vector<std::string_view>& schematic )
 	{
-		uint32_t sum_of_part_ids = 0;
-		//iterate through line by line looking for symbols
-		//once symbol found look in row above, this row and row below for part numbers adjacent to symbol
-		for ( int32_t row = 0; row < schematic.size(); ++row )
+		//small schematics stay in one band
+		constexpr size_t min_band_rows = 512;
+		const size_t band_count = parallel::chunk_count( schematic.size(), min_band_rows );
+		std::vector<Answers> band_answers( band_count, Answers{} );
+		parallel::for_each_index( band_count, [&]( const size_t band )
+								  {
+									  const size_t first_row = band * schematic.size() / band_count;
+									  const size_t end_row = (band + 1) * schematic.size() / band_count;
+									  const size_t halo_first_row = (first_row > 0) ? first_row - 1 : first_row;
+									  const size_t halo_end_row = std::min( end_row + 1, schematic.size() );
+									  const std::span<const std::string_view> rows( schematic.data() + halo_first_row, halo_end_row - halo_first_row );
+									  const Parts parts = extract_parts( rows );
+									  band_answers[band] = sum_symbol_neighbours( rows, parts, first_row - halo_first_row, end_row - halo_first_row );
+								  } );
+		//combined in band order so the totals don't depend on which thread finished first
+		Answers answers = {};
+		for ( const auto& band : band_answers )
 		{
-			//process each row string
-			const std::string& row_string = schematic[row];
-			//find the symbol character
-			size_t pos = row_string.find_first_not_of( ".0123456789" );
-			while ( pos != std::string::npos )
+			answers.part_number_sum += band.part_number_sum;
+			answers.gear_ratio_sum += band.gear_ratio_sum;
+		}
+		return answers;
+	}
+
+	/**
+	 * @brief the solver as it was before the per cell part index and the row bands,
+	 *        kept as the registry's reference so --check compares the rewrite against it
+	 */
+	namespace reference
+	{
+		std::vector<std::string> read_input( const std::string_view input )
+		{
+			std::vector<std::string> schematic = {};
+			//read the input and parse into a vector of games
+			buffer::Stream input_stream( input );
+			if ( !input.empty() )
 			{
-				//process the symbol position to find any neighbouring parts
-				//iterate over row above and below
-				for ( int i = 0; i < 3; ++i )
+				for ( std::string line; std::getline( input_stream, line ); )
 				{
-					std::vector<uint32_t> part_ids = get_parts_on_row_for_symbol_at_pos( static_cast<uint32_t>(pos), row - 1 + i, parts );
-					sum_of_part_ids += std::accumulate(part_ids.begin(), part_ids.end(), 0);
+					if ( line.length() > 0 )
+					{
+						schematic.push_back( line );
+					}
 				}
-				//find next symbol
-				pos = row_string.find_first_not_of( ".0123456789", pos+1 );
 			}
+			return schematic;
 		}
-		return sum_of_part_ids;
-	}
 
-	uint32_t part_2( const std::vector<std::string>& schematic, const std::vector<std::vector<Part>>& parts )
-	{
-		uint32_t sum_of_product_of_part_ids = 0;
-		//iterate through line by line looking for gear symbols -- part 2 is looking for gear ratio's
-		//once symbol found look in row above, this row and row below for part numbers adjacent to symbol
-		for ( int32_t row = 0; row < schematic.size(); ++row )
+		struct Part
 		{
-			//process each row string
-			const std::string& row_string = schematic[row];
-			//find the gear symbol character
-			size_t pos = row_string.find_first_of( '*' );
-			while ( pos != std::string::npos )
+			uint32_t id;
+			uint32_t row;
+			uint32_t start;
+			uint32_t end;
+		};
+
+		std::vector<std::vector<Part>> extract_parts( const std::vector<std::string>& schematic )
+		{
+			std::vector<std::vector<Part>> parts = {};
+			//iterate over all rows in the schematic extracting parts
+			for ( uint32_t row = 0; row < schematic.size(); ++row )
 			{
-				std::vector<uint32_t> part_ids = {};
-				//process the symbol position to find any neighbouring parts
-				//iterate over row above and below
-				for ( int i = 0; i < 3; ++i )
+				std::vector<Part> row_parts = {};
+				//process each row string
+				const std::string& row_string = schematic[row];
+				size_t start_pos = row_string.find_first_of( "0123456789" );
+				while(  start_pos != std::string::npos )
 				{
-					std::vector<uint32_t> row_part_ids = get_parts_on_row_for_symbol_at_pos( static_cast<uint32_t>(pos), row - 1 + i, parts );
-					part_ids.insert( part_ids.end(), row_part_ids.begin(), row_part_ids.end() );
-					
+					uint32_t id;
+					size_t end_pos = row_string.find_first_not_of( "0123456789", start_pos );
+					if( end_pos == std::string::npos )
+					{
+						//found the end of the line so process from start to end as a part number
+						std::stringstream( row_string.substr( start_pos ) ) >> id;
+						end_pos = row_string.size();
+					}
+					else
+					{
+						std::stringstream( row_string.substr( start_pos, end_pos - start_pos ) ) >> id;
+					}
+					row_parts.push_back( {id, row, static_cast<uint32_t>(start_pos), static_cast<uint32_t>(end_pos-1)} );
+					start_pos = row_string.find_first_of("0123456789", end_pos );
 				}
-				if ( part_ids.size() > 1 )
+				parts.push_back( row_parts );
+			}
+			return parts;
+		}
+
+		std::vector<uint32_t> get_parts_on_row_for_symbol_at_pos( const uint32_t pos, const int32_t row, const std::vector<std::vector<Part>>& parts )
+		{
+			std::vector<uint32_t> part_ids = {};
+			if ( row < 0 || row >= parts.size() )
+			{
+				return part_ids;
+			}
+			//scan the parts on this row to see if any are adjacent to the position passed in
+			const std::vector<Part> row_parts = parts[row];
+			for ( const auto& part : row_parts )
+			{
+
+				const uint32_t dist_to_start = (part.start > pos) ? part.start - pos : pos - part.start;
+				const uint32_t dist_to_end = (part.end > pos) ? part.end - pos : pos - part.end;
+				if ( dist_to_start <= 1 || dist_to_end <= 1 )
 				{
-					sum_of_product_of_part_ids += std::accumulate( part_ids.begin(), part_ids.end(), 1, std::multiplies<>() );
+					//part is adjacent to symbol
+					part_ids.push_back( part.id );
 				}
-				//find next symbol
-				pos = row_string.find_first_of( '*', pos + 1 );
 			}
+			return part_ids;
+		}
+
+		uint32_t part_1(const std::vector<std::string>& schematic, const std::vector<std::vector<Part>>& parts )
+		{
+			uint32_t sum_of_part_ids = 0;
+			//iterate through line by line looking for symbols
+			//once symbol found look in row above, this row and row below for part numbers adjacent to symbol
+			for ( int32_t row = 0; row < schematic.size(); ++row )
+			{
+				//process each row string
+				const std::string& row_string = schematic[row];
+				//find the symbol character
+				size_t pos = row_string.find_first_not_of( ".0123456789" );
+				while ( pos != std::string::npos )
+				{
+					//process the symbol position to find any neighbouring parts
+					//iterate over row above and below
+					for ( int i = 0; i < 3; ++i )
+					{
+						std::vector<uint32_t> part_ids = get_parts_on_row_for_symbol_at_pos( static_cast<uint32_t>(pos), row - 1 + i, parts );
+						sum_of_part_ids += std::accumulate(part_ids.begin(), part_ids.end(), 0);
+					}
+					//find next symbol
+					pos = row_string.find_first_not_of( ".0123456789", pos+1 );
+				}
+			}
+			return sum_of_part_ids;
+		}
+
+		uint32_t part_2( const std::vector<std::string>& schematic, const std::vector<std::vector<Part>>& parts )
+		{
+			uint32_t sum_of_product_of_part_ids = 0;
+			//iterate through line by line looking for gear symbols -- part 2 is looking for gear ratio's
+			//once symbol found look in row above, this row and row below for part numbers adjacent to symbol
+			for ( int32_t row = 0; row < schematic.size(); ++row )
+			{
+				//process each row string
+				const std::string& row_string = schematic[row];
+				//find the gear symbol character
+				size_t pos = row_string.find_first_of( '*' );
+				while ( pos != std::string::npos )
+				{
+					std::vector<uint32_t> part_ids = {};
+					//process the symbol position to find any neighbouring parts
+					//iterate over row above and below
+					for ( int i = 0; i < 3; ++i )
+					{
+						std::vector<uint32_t> row_part_ids = get_parts_on_row_for_symbol_at_pos( static_cast<uint32_t>(pos), row - 1 + i, parts );
+						part_ids.insert( part_ids.end(), row_part_ids.begin(), row_part_ids.end() );
+
+					}
+					if ( part_ids.size() > 1 )
+					{
+						sum_of_product_of_part_ids += std::accumulate( part_ids.begin(), part_ids.end(), 1, std::multiplies<>() );
+					}
+					//find next symbol
+					pos = row_string.find_first_of( '*', pos + 1 );
+				}
+			}
+			return sum_of_product_of_part_ids;
 		}
-		return sum_of_product_of_part_ids;
 	}
+}
+
+Result aoc::day_03( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	const std::vector<std::string_view> schematic = day_03::read_input( input );
+
+	//part 2 is answered by the same pass over the symbols as part 1, the parts are indexed band by band alongside it
+	profiler::set_phase( "part_1" );
+	const day_03::Answers answers = day_03::sum_bands( schematic );
+
+	timer::stop();
+
+	return { std::string( " 3: Engine Parts" ), answers.part_number_sum, answers.gear_ratio_sum, timer::get_elapsed_seconds() };
 
 }
 
-Result aoc::day_03()
+Result references::day_03( const std::string_view input )
 {
 	timer::start();
-	const std::vector<std::string> schematic = day_03::read_input_file( "./input/day_03.txt" );
-	const std::vector<std::vector<day_03::Part>> parts = day_03::extract_parts( schematic );
+	profiler::set_phase( "parse" );
+	const std::vector<std::string> schematic = day_03::reference::read_input( input );
+	const std::vector<std::vector<day_03::reference::Part>> parts = day_03::reference::extract_parts( schematic );
 
-	const uint64_t part_1_answer = day_03::part_1(schematic, parts);
-	const uint64_t part_2_answer = day_03::part_2( schematic, parts );
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_answer = day_03::reference::part_1( schematic, parts );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_03::reference::part_2( schematic, parts );
 
 	timer::stop();
 
 	return { std::string( " 3: Engine Parts" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+//add the parts in the three cells of a window row around column
+static void add_neighbour_parts( const schematic_window::Window_Row& row, const size_t column, uint64_t& id_sum, uint64_t& id_product, uint32_t& part_count )
+{
+	uint32_t previous_slot = day_03::Parts::no_part;
+	for ( size_t x = (column > 0) ? column - 1 : column; x <= column + 1 && x < row.cell_part.size(); ++x )
+	{
+		const uint32_t slot = row.cell_part[x];
+		if ( slot != day_03::Parts::no_part && slot != previous_slot )
+		{
+			id_sum += row.ids[slot];
+			id_product *= row.ids[slot];
+			++part_count;
+		}
+		previous_slot = slot;
+	}
+}
+
+//sum the symbols of row number n, the rows either side of it are the ones still in the window
+static void sum_window_row( schematic_window::Window& window, const uint64_t n )
+{
+	const schematic_window::Window_Row& row = window.rows[n % 3];
+	const schematic_window::Window_Row* above = (n > 0) ? &window.rows[(n - 1) % 3] : nullptr;
+	const schematic_window::Window_Row* below = (n + 1 < window.row_count) ? &window.rows[(n + 1) % 3] : nullptr;
+	for ( size_t column = 0; column < row.text.size(); ++column )
+	{
+		if ( !day_03::is_symbol( row.text[column] ) )
+		{
+			continue;
+		}
+		uint64_t id_sum = {};
+		uint64_t id_product = 1;
+		uint32_t part_count = {};
+		for ( const auto* neighbour : { above, &row, below } )
+		{
+			if ( neighbour != nullptr )
+			{
+				add_neighbour_parts( *neighbour, column, id_sum, id_product, part_count );
+			}
+		}
+		window.totals.part_number_sum += id_sum;
+		if ( row.text[column] == '*' && part_count > 1 )
+		{
+			window.totals.gear_ratio_sum += id_product;
+		}
+	}
+}
+
+void schematic_window::push_row( Window& window, const std::string_view row )
+{
+	//blank lines are skipped as read_input skips them
+	if ( row.empty() )
+	{
+		return;
+	}
+	//the slot being overwritten held the row three back which no longer has a neighbour to be summed
+	Window_Row& slot = window.rows[window.row_count % 3];
+	slot.text.assign( row );
+	slot.cell_part.assign( row.size(), day_03::Parts::no_part );
+	slot.ids.clear();
+	for ( size_t column = 0; column < row.size(); )
+	{
+		if ( !day_03::is_digit( row[column] ) )
+		{
+			++column;
+			continue;
+		}
+		const uint32_t part = static_cast<uint32_t>(slot.ids.size());
+		uint32_t id = {};
+		for ( ; column < row.size() && day_03::is_digit( row[column] ); ++column )
+		{
+			id = id * 10 + static_cast<uint32_t>(row[column] - '0');
+			slot.cell_part[column] = part;
+		}
+		slot.ids.push_back( id );
+	}
+	++window.row_count;
+	//the row before this one now has both of its neighbours
+	if ( window.row_count > 1 )
+	{
+		sum_window_row( window, window.row_count - 2 );
+	}
+}
+
+schematic_window::Totals schematic_window::finish( Window& window )
+{
+	if ( window.row_count > 0 )
+	{
+		sum_window_row( window, window.row_count - 1 );
+	}
+	return window.totals;
+}
+
+schematic_window::Totals schematic_window::solve( std::istream& input )
+{
+	Window window = {};
+	for ( std::string line; std::getline( input, line ); )
+	{
+		push_row( window, line );
+	}
+	return finish( window );
+}
 
+Result schematic_window::solve_input( const std::string_view input )
+{
+	timer::start();
+	buffer::Stream input_stream( input );
+	const Totals totals = solve( input_stream );
+	timer::stop();
+
+	return { std::string( " 3: Engine Parts" ), totals.part_number_sum, totals.gear_ratio_sum, timer::get_elapsed_seconds() };
+}
+
+std::string generators::day_03( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	const std::string symbols = "*#+$/@%=&-";
+	std::vector<std::string> schematic( 140, std::string( 140, '.' ) );
+	for ( auto& row : schematic )
+	{
+		//numbers are always followed by at least one '.' so neighbouring numbers never run together
+		for ( size_t x = rng() % 4; x + 4 < row.size(); x += 2 + rng() % 6 )
+		{
+			if ( rng() % 3 == 0 )
+			{
+				row[x] = symbols[rng() % symbols.size()];
+				continue;
+			}
+			const std::string number = std::to_string( 1 + rng() % 999 );
+			row.replace( x, number.size(), number );
+			x += number.size();
+		}
+	}
+	std::stringstream ss;
+	for ( const auto& row : schematic )
+	{
+		ss << row << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,57 +6,185 @@
 //\==============================================================================
 
 
+#include "buffer.h"
+#include "card_stream.h"
 #include "days.h"
+#include "cpu_dispatch.h"
+#include "profiler.h"
 #include "result.h"
 #include "timer.h"
+#include "solvers.h"
+#include "structural.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
+#include <bit>
+#include <iomanip>
 #include <numeric>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace day_04
 {
 
-	struct Card
+	//card numbers are below 128 so each side of a card is a 128 bit set held in two words, bit n is set if n is on that side
+	struct Cards
 	{
-		std::vector<uint32_t> winning_numbers;
-		std::vector<uint32_t> numbers_you_have;
-
-		uint32_t copies = { 1 };
+		std::vector<uint64_t> winning;	/** < two words per card */
+		std::vector<uint64_t> have;
 	};
 
-	std::vector<Card> read_input_file( const std::string& input_file )
+	//set the bit of every number in text
+	void read_numbers( const std::string_view text, uint64_t* mask )
+	{
+		for ( size_t i = 0; i < text.size(); )
+		{
+			if ( text[i] < '0' || text[i] > '9' )
+			{
+				++i;
+				continue;
+			}
+			uint32_t value = {};
+			for ( ; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i )
+			{
+				value = value * 10 + static_cast<uint32_t>(text[i] - '0');
+			}
+			if ( value >= 128 )
+			{
+				throw std::invalid_argument( "card number " + std::to_string( value ) + " does not fit in a 128 bit mask" );
+			}
+			mask[value / 64] |= 1ULL << (value % 64);
+		}
+	}
+
+	Cards read_input( const std::string_view input )
+	{
+		Cards cards = {};
+		//read the input and parse into a vector of games
+		const structural::Index index = structural::build( input );
+		for ( size_t l = 0; l < structural::line_count( index ); ++l )
+		{
+			const std::string_view line = structural::line( index, l );
+			if ( line.length() > 0 )
+			{
+				//the index holds the ':' and '|' symbols, the winning numbers sit between them
+				const size_t colon_pos = structural::find_in_line( index, l );
+				const size_t pipe_pos = structural::find_in_line( index, l, colon_pos + 1 );
+				cards.winning.resize( cards.winning.size() + 2, 0 );
+				cards.have.resize( cards.have.size() + 2, 0 );
+				read_numbers( line.substr( colon_pos + 1, pipe_pos - (colon_pos + 1) ), cards.winning.data() + cards.winning.size() - 2 );
+				//read from the '|' symbol to the end of line to find the numbers you have
+				read_numbers( line.substr( pipe_pos + 1 ), cards.have.data() + cards.have.size() - 2 );
+			}
+		}
+		return cards;
+	}
+
+	//matches of every card, one AND and popcount per card with several cards in each vector
+	std::vector<uint8_t> count_matches( const Cards& cards )
 	{
-		std::vector<Card> cards = {};
-		//open the input file for and parse into a vector of games
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		std::vector<uint8_t> matches( cards.winning.size() / 2, 0 );
+		cpu::kernels().count_card_matches( cards.winning.data(), cards.have.data(), matches.size(), matches.data() );
+		return matches;
+	}
+
+	uint64_t part_1( const std::vector<uint8_t>& matches )
+	{
+		uint64_t accumulated_points = {};
+		for ( const uint8_t card_matches : matches )
+		{
+			if ( card_matches != 0 )
+			{
+				accumulated_points += (1ULL << (card_matches - 1));
+			}
+		}
+		return accumulated_points;
+	}
+
+	uint64_t part_2( const std::vector<uint8_t>& matches )
+	{
+		//every card starts with one copy and each copy wins one more of each of the next matches cards,
+		//only the copies owed to the cards ahead are held
+		card_stream::Copies<uint64_t> copies = {};
+		for ( const uint8_t card_matches : matches )
+		{
+			card_stream::push_card( copies, card_matches );
+		}
+		return copies.total;
+	}
+
+	//matches of one line of the input, a line without a card has none
+	uint32_t read_card_matches( const std::string_view line )
+	{
+		const size_t colon_pos = line.find( ':' );
+		const size_t pipe_pos = line.find( '|' );
+		if ( colon_pos == std::string_view::npos || pipe_pos == std::string_view::npos )
+		{
+			return 0;
+		}
+		uint64_t winning[2] = {};
+		uint64_t have[2] = {};
+		read_numbers( line.substr( colon_pos + 1, pipe_pos - (colon_pos + 1) ), winning );
+		read_numbers( line.substr( pipe_pos + 1 ), have );
+		return static_cast<uint32_t>(std::popcount( winning[0] & have[0] ) + std::popcount( winning[1] & have[1] ));
+	}
+
+	template <typename Count>
+	Count count_cards( std::istream& input )
+	{
+		card_stream::Copies<Count> copies = {};
+		for ( std::string line; std::getline( input, line ); )
+		{
+			if ( line.length() > 0 )
+			{
+				card_stream::push_card( copies, read_card_matches( line ) );
+			}
+		}
+		return copies.total;
+	}
+
+	/**
+	 * @brief the solver as it was before the cards were matched as 128 bit masks,
+	 *        kept as the registry's reference so --check compares the rewrite against it
+	 */
+	namespace reference
+	{
+		struct Card
+		{
+			std::vector<uint32_t> winning_numbers;
+			std::vector<uint32_t> numbers_you_have;
+
+			uint32_t copies = { 1 };
+		};
+
+		std::vector<Card> read_input( const std::string_view input )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			std::vector<Card> cards = {};
+			//read the input and parse into a vector of games
+			const structural::Index index = structural::build( input );
+			for ( size_t l = 0; l < structural::line_count( index ); ++l )
 			{
+				const std::string_view line = structural::line( index, l );
 				if ( line.length() > 0 )
 				{
-					//find the ':' symbol and read from there up to the '|' symbol to get the vector of winning numbers
-					size_t colon_pos = line.find_first_of( ':' ) + 1;
-					size_t pipe_pos = line.find_first_of( '|', colon_pos );
-					std::string winning = line.substr( colon_pos + 1, pipe_pos - colon_pos );
+					//the index holds the ':' and '|' symbols, the winning numbers sit between them
+					const size_t colon_pos = structural::find_in_line( index, l );
+					const size_t pipe_pos = structural::find_in_line( index, l, colon_pos + 1 );
+					const std::string_view winning = line.substr( colon_pos + 1, pipe_pos - (colon_pos + 1) );
 					//read from the '|' symbol to the end of line to find the numbers you have
-					std::string numbers = line.substr( pipe_pos + 1 );
+					const std::string_view numbers = line.substr( pipe_pos + 1 );
 					std::vector<uint32_t> winning_numbers = {};
 					//read out winning numbers
 					uint32_t value = {};
-					std::stringstream winning_stream( winning );
+					buffer::Stream winning_stream( winning );
 					while( winning_stream >> value )
 					{
 						winning_numbers.push_back( value );
 					}
 					std::vector<uint32_t> numbers_you_have = {};
-					std::stringstream numbers_stream( numbers );
+					buffer::Stream numbers_stream( numbers );
 					while( numbers_stream >> value )
 					{
 						numbers_you_have.push_back( value );
@@ -64,74 +192,144 @@ namespace day_04
 					cards.push_back( {winning_numbers, numbers_you_have} );
 				}
 			}
-			file_input.close();
+			return cards;
 		}
-		return cards;
-	}
-
-	
 
-	uint32_t part_1( const std::vector<Card>& cards )
-	{
-		uint32_t accumulated_points = {};
-		for( const auto& card : cards )
+		//compare every winning number against every number you have, this was the scalar count_matches kernel
+		uint32_t count_matches( const Card& card )
 		{
 			uint32_t matches = {};
-			for( const auto& number : card.winning_numbers )
-			{
-				matches += static_cast<uint32_t>( std::count( card.numbers_you_have.begin(), card.numbers_you_have.end(), number ) );
-			}
-			if( matches != 0 )
+			for ( const uint32_t winning : card.winning_numbers )
 			{
-				accumulated_points += (1 << (matches - 1));
+				matches += static_cast<uint32_t>(std::count( card.numbers_you_have.begin(), card.numbers_you_have.end(), winning ));
 			}
+			return matches;
 		}
-		
-		return accumulated_points;
-	}
 
-	uint32_t part_2( std::vector<Card>& cards )
-	{
-		uint32_t index = 0;
-		for ( const auto& card : cards )
+		uint32_t part_1( const std::vector<Card>& cards )
 		{
-			uint32_t matches = {};
-			for ( const auto& number : card.winning_numbers )
-			{
-				matches += static_cast<uint32_t>(std::count( card.numbers_you_have.begin(), card.numbers_you_have.end(), number ));
-			}
-			if ( matches != 0 )
+			uint32_t accumulated_points = {};
+			for( const auto& card : cards )
 			{
-				//get the next matches number of cards and increment their copies value by the 1 * number of copies of this card
-				for( uint32_t i = 1; i <= matches; ++i )
+				const uint32_t matches = count_matches( card );
+				if( matches != 0 )
 				{
-					cards[index + i].copies += card.copies;
+					accumulated_points += (1 << (matches - 1));
 				}
 			}
 
-			++index; //increment the card index
+			return accumulated_points;
 		}
 
-		return std::accumulate( cards.begin(), cards.end(), 0, 
-								[]( uint32_t sum, const Card& curr )
-								{
-									return sum + curr.copies;
-								});
-	}
+		uint32_t part_2( std::vector<Card>& cards )
+		{
+			uint32_t index = 0;
+			for ( const auto& card : cards )
+			{
+				const uint32_t matches = count_matches( card );
+				if ( matches != 0 )
+				{
+					//get the next matches number of cards and increment their copies value by the 1 * number of copies of this card
+					for( uint32_t i = 1; i <= matches; ++i )
+					{
+						cards[index + i].copies += card.copies;
+					}
+				}
 
+				++index; //increment the card index
+			}
 
+			return std::accumulate( cards.begin(), cards.end(), 0,
+									[]( uint32_t sum, const Card& curr )
+									{
+										return sum + curr.copies;
+									});
+		}
+	}
 }
 
-Result aoc::day_04()
+Result aoc::day_04( const std::string_view input )
 {
 	timer::start();
-	std::vector<day_04::Card> cards = day_04::read_input_file( "./input/day_04.txt" );
+	profiler::set_phase( "parse" );
+	const day_04::Cards cards = day_04::read_input( input );
 	
-	const uint64_t part_1_answer = day_04::part_1( cards );
-	const uint64_t part_2_answer = day_04::part_2( cards );
+	//the match counts are shared by both parts
+	profiler::set_phase( "part_1" );
+	const std::vector<uint8_t> matches = day_04::count_matches( cards );
+	const uint64_t part_1_answer = day_04::part_1( matches );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_04::part_2( matches );
 
 	timer::stop();
 
 	return { std::string( " 4: Scratchies!" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 	
+}
+
+Result references::day_04( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	std::vector<day_04::reference::Card> cards = day_04::reference::read_input( input );
+
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_answer = day_04::reference::part_1( cards );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_04::reference::part_2( cards );
+
+	timer::stop();
+
+	return { std::string( " 4: Scratchies!" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+uint64_t card_stream::count_cards( std::istream& input )
+{
+	return day_04::count_cards<uint64_t>( input );
+}
+
+wide::Uint128 card_stream::count_cards_wide( std::istream& input )
+{
+	return day_04::count_cards<wide::Uint128>( input );
+}
+
+std::string generators::day_04( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	constexpr uint32_t card_count = 200;
+	//track the copies won so far so the generated cards can't overflow the 32 bit copy counts
+	std::vector<uint64_t> copies( card_count, 1 );
+	std::stringstream ss;
+	for ( uint32_t card = 0; card < card_count; ++card )
+	{
+		std::vector<uint32_t> numbers( 99 );
+		std::iota( numbers.begin(), numbers.end(), 1 );
+		std::shuffle( numbers.begin(), numbers.end(), rng );
+		uint32_t matches = (rng() % 4 == 0) ? rng() % 11 : rng() % 3;
+		matches = std::min( matches, card_count - 1 - card );
+		if ( copies[card] > 1000000 )
+		{
+			matches = 0;
+		}
+		for ( uint32_t m = 1; m <= matches; ++m )
+		{
+			copies[card + m] += copies[card];
+		}
+		//the first 10 shuffled numbers win, the numbers you have take the matches from them and the rest from beyond them
+		std::vector<uint32_t> have( numbers.begin(), numbers.begin() + matches );
+		have.insert( have.end(), numbers.begin() + 10, numbers.begin() + 10 + (25 - matches) );
+		std::shuffle( have.begin(), have.end(), rng );
+		ss << "Card " << std::setw( 3 ) << card + 1 << ":";
+		for ( uint32_t i = 0; i < 10; ++i )
+		{
+			ss << ' ' << std::setw( 2 ) << numbers[i];
+		}
+		ss << " |";
+		for ( const auto value : have )
+		{
+			ss << ' ' << std::setw( 2 ) << value;
+		}
+		ss << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,15 +6,24 @@
 //\==============================================================================
 
 
+#include "almanac.h"
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "cpu_dispatch.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
+#include "structural.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
+#include <map>
 #include <numeric>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -40,30 +49,30 @@ namespace day_05
 		std::vector<std::vector<Map>> conversion_map;
 	};
 
-	Seeds_Maps read_input_file( std::string input_file )
+	Seeds_Maps read_input( const std::string_view input )
 	{
-		//open the input file for and parse into a vector of games
+		//read the input and parse into a vector of games
 		Seeds_Maps seeds_n_maps = {};
 		std::vector<Map> parsed_maps;
 
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		const structural::Index index = structural::build( input );
+		if ( !input.empty() )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( size_t l = 0; l < structural::line_count( index ); ++l )
 			{
+				const std::string_view line = structural::line( index, l );
 				if ( line.length() > 0 )
 				{
 					//line with seeds in contains a ':' followed by list of seeds or end of range
-					size_t colon_pos = line.find_first_of( ':' );
-					if ( colon_pos != std::string::npos )
+					const size_t colon_pos = structural::find_in_line( index, l );
+					if ( colon_pos != std::string_view::npos )
 					{
 						//test to see if this is the line of seeds
-						std::string seed_ids = line.substr( colon_pos + 1 );
+						const std::string_view seed_ids = line.substr( colon_pos + 1 );
 						if ( seed_ids.size() > 0 )
 						{
 							uint64_t value = {};
-							std::stringstream ss( seed_ids );
+							buffer::Stream ss( seed_ids );
 							while ( ss >> value )
 							{
 								seeds_n_maps.seed_ids.push_back( value );
@@ -86,7 +95,7 @@ namespace day_05
 					else
 					{
 						Map map = {};
-						std::stringstream ss( line );
+						buffer::Stream ss( line );
 						ss >> map.destination;
 						ss >> map.source;
 						ss >> map.range;
@@ -103,45 +112,114 @@ namespace day_05
 				parsed_maps.clear();
 			}
 		}
-		file_input.close();
 
 		return seeds_n_maps;
 	}
 
-	/** 
-	* @brief this is the solution for part one
-	*   Each seed is an individual seed value that is pushed through the mapping process to
-	*   produce a location value. The lowest location value is returned to the calling location of this function
+	//every stage composed into one function from seed to location, shared with the batch lookup API
+	using Composed_Map = almanac::Composed_Map;
+
+	//add a piece, a piece with the same offset as the one before it only extends that piece
+	void add_piece( Composed_Map& composed, const uint64_t start, const uint64_t offset )
+	{
+		if ( !composed.offsets.empty() && composed.offsets.back() == offset )
+		{
+			return;
+		}
+		composed.starts.push_back( start );
+		composed.offsets.push_back( offset );
+	}
+
+	/**
+	* @brief the function of a single stage, values no map covers pass through unchanged.
+	*   Where maps overlap the first by source wins, as it does when the maps are scanned in order
 	*/
-	uint64_t part_01( Seeds_Maps seeds_n_maps )
+	Composed_Map stage_function( const std::vector<Map>& maps )
 	{
-		uint64_t lowest_location = INT_MAX;
-		//go through each seed and pass it through the maps to discover it's final location
-		for ( const auto& seed : seeds_n_maps.seed_ids )
+		Composed_Map stage = {};
+		uint64_t covered = {};
+		for ( const auto& map : maps )
 		{
-			uint64_t mapped_value = seed;
-			for ( const auto& maps : seeds_n_maps.conversion_map )
+			const uint64_t start = std::max( map.source, covered );
+			const uint64_t end = map.source + map.range;
+			if ( start >= end )
 			{
-				//for each stage in the pipeline convert the seed
-				for ( const auto& map : maps )
-				{
-					//is the value in the range of the map?
-					if ( mapped_value > map.source && mapped_value < map.source + map.range )
-					{
-						//if the value is in range map it to the destination range
-						const uint64_t offset = mapped_value - map.source;
-						mapped_value = map.destination + offset;
-						break;
-					}
-				}
+				continue;
 			}
-			//we have traversed this seed through to it's location mapped value
-			if ( mapped_value < lowest_location )
+			if ( start > covered || stage.starts.empty() )
 			{
-				lowest_location = mapped_value;
+				add_piece( stage, covered, 0 );
 			}
+			add_piece( stage, start, map.destination - map.source );
+			covered = end;
 		}
-		return lowest_location;
+		add_piece( stage, covered, 0 );
+		return stage;
+	}
+
+	//index of the piece holding value
+	size_t find_piece( const Composed_Map& composed, const uint64_t value )
+	{
+		return static_cast<size_t>(std::upper_bound( composed.starts.begin(), composed.starts.end(), value ) - composed.starts.begin()) - 1;
+	}
+
+	//exclusive end of a piece, the last piece ends at the largest value
+	uint64_t piece_end( const Composed_Map& composed, const size_t piece )
+	{
+		return (piece + 1 < composed.starts.size()) ? composed.starts[piece + 1] : UINT64_MAX;
+	}
+
+	/**
+	* @brief second( first( value ) ) as one function. The image of a piece of first is a single interval, it is split
+	*   wherever it crosses a piece of second, so the result has at most the pieces of both functions combined
+	*/
+	Composed_Map compose( const Composed_Map& first, const Composed_Map& second )
+	{
+		Composed_Map composed = {};
+		for ( size_t i = 0; i < first.starts.size(); ++i )
+		{
+			const uint64_t end = piece_end( first, i );
+			for ( uint64_t value = first.starts[i]; value < end; )
+			{
+				const uint64_t mapped = value + first.offsets[i];
+				const size_t j = find_piece( second, mapped );
+				//the run of values that stays inside piece j of second
+				const uint64_t run = std::min( end - value, piece_end( second, j ) - mapped );
+				add_piece( composed, value, first.offsets[i] + second.offsets[j] );
+				value += run;
+				if ( run == 0 )
+				{
+					break;
+				}
+			}
+		}
+		return composed;
+	}
+
+	Composed_Map compose_stages( const std::vector<std::vector<Map>>& conversion_map )
+	{
+		Composed_Map composed = { { 0 }, { 0 } };
+		for ( const auto& maps : conversion_map )
+		{
+			composed = compose( composed, stage_function( maps ) );
+		}
+		return composed;
+	}
+
+	uint64_t lookup( const Composed_Map& composed, const uint64_t value )
+	{
+		return value + composed.offsets[find_piece( composed, value )];
+	}
+
+	/** 
+	* @brief this is the solution for part one
+	*   Each seed is an individual seed value that is looked up in the composed map to
+	*   produce a location value. The lowest location value is returned to the calling location of this function
+	*/
+	uint64_t part_01( const Seeds_Maps& seeds_n_maps, const Composed_Map& composed )
+	{
+		std::vector<uint64_t> locations( seeds_n_maps.seed_ids.size() );
+		return almanac::locate( composed, seeds_n_maps.seed_ids.data(), seeds_n_maps.seed_ids.size(), locations.data() );
 	}
 
 	/**
@@ -169,113 +247,723 @@ namespace day_05
 	}
 
 	/** 
-	* @brief function to map the range passed in to any of the maps that satisfy that range
+	* @brief function to map the range passed in through the pieces of a stage function that it crosses
 	* @param the range to map
-	* @param the vector of maps to use to map the range
-	* @return a vector of mapped ranges
+	* @param the stage function built from the stage's maps
+	* @param the mapped ranges are appended to this, it is never cleared so callers can reuse one buffer
 	*/
-	std::vector<Range> map_ranges( Range range, std::vector<Map> maps )
+	void map_ranges( const Range range, const Composed_Map& stage, std::vector<Range>& converted_ranges )
 	{
-		std::vector<Range> converted_ranges = {};
-		
-		for ( const auto& map : maps )
+		if ( range.size == 0 )
+		{
+			return;
+		}
+		const uint64_t end = range.start + range.size;
+		for ( size_t piece = find_piece( stage, range.start ); piece < stage.starts.size() && stage.starts[piece] < end; ++piece )
+		{
+			const uint64_t overlap_start = std::max( range.start, stage.starts[piece] );
+			const uint64_t overlap_end = std::min( end, piece_end( stage, piece ) );
+			converted_ranges.push_back( { overlap_start + stage.offsets[piece], overlap_end - overlap_start } );
+		}
+	}
+
+	//sort the ranges and merge any that overlap or touch so the count stays bounded by the pieces of the stages
+	void coalesce( std::vector<Range>& ranges )
+	{
+		std::sort( ranges.begin(), ranges.end(), []( const Range& a, const Range& b ) { return a.start < b.start; } );
+		size_t count = {};
+		for ( size_t i = 0; i < ranges.size(); ++i )
 		{
-			if ( range.size == 0 ) //no more values to try to map so break out of this loop
+			if ( count > 0 && ranges[i].start <= ranges[count - 1].start + ranges[count - 1].size )
 			{
-				break;
+				Range& last = ranges[count - 1];
+				last.size = std::max( last.size, ranges[i].start + ranges[i].size - last.start );
 			}
-			//test to see if range overlaps (this is very much an AABB test in a single dimension)
-			if ( range.start < map.source + map.range && map.source < range.start + range.size )
+			else
 			{
-				//there is an overlap with this range.Find overlap minimal/maximal
-				uint64_t overlap_start = std::max( range.start, map.source );
-				uint64_t overlap_end = std::min( range.start + range.size, map.source + map.range );
-				//calculate the range of the overlap
-				uint64_t overlap_range = overlap_end - overlap_start;
-				
-				if ( overlap_start > range.start ) //any seeds prior to the start of this overlap should be sent through unconverted
-				{
-					Range sr = { range.start, overlap_start - range.start };
-					//stick the seeds into the conversion ranges as they just pass through
-					converted_ranges.push_back( sr );
-				}
-				//map start to destination value
-				uint64_t offset = std::max( range.start, map.source ) - std::min( range.start, map.source );
-				uint64_t destination = map.destination + offset;
-				//push back the mapped range
-				converted_ranges.push_back( { destination, overlap_range } );
-
-				//reduce range by overlapped amount
-				range.size -= overlap_end - range.start;
-				
-				//adjust starting point of current range
-				range.start = overlap_start + overlap_range;
+				ranges[count++] = ranges[i];
 			}
+		}
+		ranges.resize( count );
+	}
+
+	/**
+	* @brief buffers reused between the stages and between calls, they only grow
+	*/
+	struct Range_Scratch
+	{
+		std::vector<Range> current;
+		std::vector<Range> next;
+		std::vector<std::vector<Range>> chunks;	/** < mapped ranges of each chunk of current */
+	};
 
+	/**
+	* @brief map seed ranges a stage at a time, the ranges of a stage are split into chunks mapped on the worker threads
+	*   and the results are coalesced before the next stage
+	* @param interval_counts is set to the number of ranges after coalescing, the seed ranges first then one count per stage
+	* @return the lowest location, the start of the first range once the last stage is sorted
+	*/
+	uint64_t map_stages( const std::vector<Range>& seed_ranges, const std::vector<Composed_Map>& stages, Range_Scratch& scratch, std::vector<size_t>& interval_counts )
+	{
+		constexpr size_t min_chunk_ranges = 256;
+		scratch.current.assign( seed_ranges.begin(), seed_ranges.end() );
+		coalesce( scratch.current );
+		interval_counts.assign( 1, scratch.current.size() );
+		for ( const auto& stage : stages )
+		{
+			const std::vector<Range>& current = scratch.current;
+			const size_t chunk_count = parallel::chunk_count( current.size(), min_chunk_ranges );
+			if ( scratch.chunks.size() < chunk_count )
+			{
+				scratch.chunks.resize( chunk_count );
+			}
+			parallel::for_each_index( chunk_count, [&]( const size_t chunk )
+									  {
+										  std::vector<Range>& mapped = scratch.chunks[chunk];
+										  mapped.clear();
+										  const size_t end = (chunk + 1) * current.size() / chunk_count;
+										  for ( size_t i = chunk * current.size() / chunk_count; i < end; ++i )
+										  {
+											  map_ranges( current[i], stage, mapped );
+										  }
+									  } );
+			scratch.next.clear();
+			for ( size_t chunk = 0; chunk < chunk_count; ++chunk )
+			{
+				scratch.next.insert( scratch.next.end(), scratch.chunks[chunk].begin(), scratch.chunks[chunk].end() );
+			}
+			coalesce( scratch.next );
+			std::swap( scratch.current, scratch.next );
+			interval_counts.push_back( scratch.current.size() );
 		}
-		//any trailing values that have not overlapped need to be sent through to the next mapping stage.
-		if ( range.size != 0 )
+		return scratch.current.empty() ? UINT64_MAX : scratch.current.front().start;
+	}
+
+	//an engine with no rules and no seeds
+	almanac::Engine new_engine( const size_t stage_count )
+	{
+		almanac::Engine engine = {};
+		engine.stages.resize( stage_count );
+		for ( auto& stage : engine.stages )
+		{
+			stage.seeds = { { 0, 0 } };
+		}
+		engine.locations = { { 0, 0 } };
+		return engine;
+	}
+
+	//add count to the seeds reaching every value of [begin, end), an end of UINT64_MAX runs to the end of the values
+	void add_seeds( std::map<uint64_t, int64_t>& seeds, const uint64_t begin, const uint64_t end, const int64_t count )
+	{
+		//split the steps at begin and end so the steps between them lie inside the interval, there is always a step at 0
+		const auto split = [&seeds]( const uint64_t value )
+		{
+			const auto step = std::prev( seeds.upper_bound( value ) );
+			return (step->first == value) ? step : seeds.emplace_hint( std::next( step ), value, step->second );
+		};
+		const auto first = split( begin );
+		const auto last = (end == UINT64_MAX) ? seeds.end() : split( end );
+		for ( auto step = first; step != last; ++step )
+		{
+			step->second += count;
+		}
+		//the steps between first and last all moved together so neighbouring steps can only have become equal at the ends
+		if ( last != seeds.end() && std::prev( last )->second == last->second )
+		{
+			seeds.erase( last );
+		}
+		if ( first != seeds.begin() && std::prev( first )->second == first->second )
+		{
+			seeds.erase( first );
+		}
+	}
+
+	//call piece( begin, end, offset ) for each part of [begin, end) under a single rule or a single gap between rules
+	template <typename Piece>
+	void for_each_piece( const std::map<uint64_t, almanac::Rule>& rules, uint64_t begin, const uint64_t end, Piece piece )
+	{
+		auto rule = rules.upper_bound( begin );
+		if ( rule != rules.begin() && std::prev( rule )->second.source + std::prev( rule )->second.range > begin )
+		{
+			--rule;
+		}
+		while ( begin < end )
+		{
+			uint64_t part_end = end;
+			uint64_t offset = {};
+			if ( rule != rules.end() && rule->second.source <= begin )
+			{
+				part_end = std::min( end, rule->second.source + rule->second.range );
+				offset = rule->second.destination - rule->second.source;
+				++rule;
+			}
+			else if ( rule != rules.end() )
+			{
+				part_end = std::min( end, rule->second.source );
+			}
+			piece( begin, part_end, offset );
+			begin = part_end;
+		}
+	}
+
+	//count seeds reaching [begin, end) of a stage and every value they map to in the stages after it
+	void push_seeds( almanac::Engine& engine, const size_t stage, const uint64_t begin, const uint64_t end, const int64_t count )
+	{
+		if ( begin >= end || count == 0 )
+		{
+			return;
+		}
+		if ( stage == engine.stages.size() )
+		{
+			add_seeds( engine.locations, begin, end, count );
+			return;
+		}
+		add_seeds( engine.stages[stage].seeds, begin, end, count );
+		for_each_piece( engine.stages[stage].rules, begin, end, [&engine, stage, count]( const uint64_t part_begin, const uint64_t part_end, const uint64_t offset )
+						{
+							push_seeds( engine, stage + 1, part_begin + offset, part_end + offset, count );
+						} );
+	}
+
+	//the seeds reaching [begin, end) of a stage stop being sent on with old_offset and are sent on with new_offset instead
+	void move_seeds( almanac::Engine& engine, const size_t stage, const uint64_t begin, const uint64_t end, const uint64_t old_offset, const uint64_t new_offset )
+	{
+		//only the stages after this one change so its steps can be walked while the seeds are pushed
+		const std::map<uint64_t, int64_t>& seeds = engine.stages[stage].seeds;
+		for ( auto step = std::prev( seeds.upper_bound( begin ) ); step != seeds.end() && step->first < end; ++step )
 		{
-			converted_ranges.push_back( { range.start, range.size } );
+			const auto next = std::next( step );
+			const uint64_t step_begin = std::max( begin, step->first );
+			const uint64_t step_end = (next != seeds.end()) ? std::min( end, next->first ) : end;
+			push_seeds( engine, stage + 1, step_begin + old_offset, step_end + old_offset, -step->second );
+			push_seeds( engine, stage + 1, step_begin + new_offset, step_end + new_offset, step->second );
 		}
-		return converted_ranges;
+	}
+
+	std::vector<Composed_Map> stage_functions( const std::vector<std::vector<Map>>& conversion_map )
+	{
+		std::vector<Composed_Map> stages = {};
+		stages.reserve( conversion_map.size() );
+		for ( const auto& maps : conversion_map )
+		{
+			stages.push_back( stage_function( maps ) );
+		}
+		return stages;
 	}
 
 	/** 
 	* @brief Solution to part 2 of problem now seeds need to be treated as a pair of values with starting location and range.
+	*   Each piece of the composed map is increasing, so the lowest location of the seeds in a piece is the location of its first seed
+	*   and a range costs one lookup per piece it crosses
 	* @param the input data read in from the input dataset
 	* @return the lowest location value for the mapped seeds
 	*/
-	uint64_t part_02( Seeds_Maps seeds_n_maps )
-	{
-		uint64_t lowest_location = INT_MAX;
-		//convert seeds to seed ranges
-		std::vector<Range> seed_ranges = convert_seeds_to_seed_range( seeds_n_maps );
-		
-		//for each range of seeds 
-		for ( const auto& seeds : seed_ranges )
-		{
-			//set an active range to be mapping down to a location 
-			std::vector<Range> active_ranges = {seeds};
-			//for each mapping stage 
-			for ( const auto& maps : seeds_n_maps.conversion_map )
+	uint64_t part_02( const Seeds_Maps& seeds_n_maps, const Composed_Map& composed )
+	{
+		uint64_t lowest_location = UINT64_MAX;
+		for ( const auto& seeds : convert_seeds_to_seed_range( seeds_n_maps ) )
+		{
+			if ( seeds.size == 0 )
+			{
+				continue;
+			}
+			const uint64_t end = seeds.start + seeds.size;
+			for ( size_t piece = find_piece( composed, seeds.start ); piece < composed.starts.size() && composed.starts[piece] < end; ++piece )
+			{
+				lowest_location = std::min( lowest_location, std::max( seeds.start, composed.starts[piece] ) + composed.offsets[piece] );
+			}
+		}
+		return lowest_location;
+	}
+
+	/**
+	 * @brief the solver as it was before the stages were composed into one function, kept as the registry's reference so
+	 *        --check compares the rewrite against it. The two mapping bugs found while composing the stages are fixed here
+	 *        as well and marked, along with the INT_MAX starting location that some generated locations were above and
+	 *        a read past the end for an empty seed range
+	 */
+	namespace reference
+	{
+		/**
+		* @brief Each seed is an individual seed value that is pushed through the mapping process to
+		*   produce a location value. The lowest location value is returned
+		*/
+		uint64_t part_01( const Seeds_Maps& seeds_n_maps )
+		{
+			//fixed: started from INT_MAX
+			uint64_t lowest_location = UINT64_MAX;
+			//go through each seed and pass it through the maps to discover it's final location
+			for ( const auto& seed : seeds_n_maps.seed_ids )
 			{
-				//keep track of converted ranges for the next set of active ranges
-				std::vector<Range> converted_ranges = {};
-				//for each active range we will map it to the next stage of the mapping pipeline
-				for ( auto& current_range : active_ranges )
+				uint64_t mapped_value = seed;
+				for ( const auto& maps : seeds_n_maps.conversion_map )
 				{
-					//map the current range to the next stage of the pipeline
-					std::vector<Range> conversions = map_ranges( current_range, maps );
-					//append any converted ranges to keep track of conversions for each of the maps in this stage
-					converted_ranges.insert( converted_ranges.end(), conversions.begin(), conversions.end() );
+					//for each stage in the pipeline convert the seed
+					for ( const auto& map : maps )
+					{
+						//is the value in the range of the map? fixed: a value equal to the source was skipped
+						if ( mapped_value >= map.source && mapped_value < map.source + map.range )
+						{
+							//if the value is in range map it to the destination range
+							const uint64_t offset = mapped_value - map.source;
+							mapped_value = map.destination + offset;
+							break;
+						}
+					}
+				}
+				//we have traversed this seed through to it's location mapped value
+				if ( mapped_value < lowest_location )
+				{
+					lowest_location = mapped_value;
 				}
-				//sort the converted ranges by starting location - sorting the list allows us to ensure that anything prior to the first matching mapped range is passed through 
-				std::sort( converted_ranges.begin(), converted_ranges.end(), []( const Range& a, const Range& b ) { return a.start < b.start; } );
-				//change the active range to the converted range
-				active_ranges = converted_ranges;
 			}
-			//keep tabs on the lowest location value returned from the mapping process
-			if ( active_ranges[0].start < lowest_location )
+			return lowest_location;
+		}
+
+		/**
+		* @brief function to map the range passed in to any of the maps that satisfy that range
+		* @param the range to map
+		* @param the vector of maps to use to map the range
+		* @return a vector of mapped ranges
+		*/
+		std::vector<Range> map_ranges( Range range, const std::vector<Map>& maps )
+		{
+			std::vector<Range> converted_ranges = {};
+
+			for ( const auto& map : maps )
 			{
-				lowest_location = active_ranges[0].start;
+				if ( range.size == 0 ) //no more values to try to map so break out of this loop
+				{
+					break;
+				}
+				//test to see if range overlaps (this is very much an AABB test in a single dimension)
+				if ( range.start < map.source + map.range && map.source < range.start + range.size )
+				{
+					//there is an overlap with this range.Find overlap minimal/maximal
+					uint64_t overlap_start = std::max( range.start, map.source );
+					uint64_t overlap_end = std::min( range.start + range.size, map.source + map.range );
+					//calculate the range of the overlap
+					uint64_t overlap_range = overlap_end - overlap_start;
+
+					if ( overlap_start > range.start ) //any seeds prior to the start of this overlap should be sent through unconverted
+					{
+						Range sr = { range.start, overlap_start - range.start };
+						//stick the seeds into the conversion ranges as they just pass through
+						converted_ranges.push_back( sr );
+					}
+					//map start to destination value. fixed: a range starting before the map was offset by the distance to the map
+					uint64_t offset = overlap_start - map.source;
+					uint64_t destination = map.destination + offset;
+					//push back the mapped range
+					converted_ranges.push_back( { destination, overlap_range } );
+
+					//reduce range by overlapped amount
+					range.size -= overlap_end - range.start;
+
+					//adjust starting point of current range
+					range.start = overlap_start + overlap_range;
+				}
+
+			}
+			//any trailing values that have not overlapped need to be sent through to the next mapping stage.
+			if ( range.size != 0 )
+			{
+				converted_ranges.push_back( { range.start, range.size } );
 			}
+			return converted_ranges;
 		}
-		return lowest_location;
+
+		/**
+		* @brief seeds are treated as a pair of values with starting location and range.
+		* @param the input data read in from the input dataset
+		* @return the lowest location value for the mapped seeds
+		*/
+		uint64_t part_02( const Seeds_Maps& seeds_n_maps )
+		{
+			//fixed: started from INT_MAX
+			uint64_t lowest_location = UINT64_MAX;
+			//convert seeds to seed ranges
+			std::vector<Range> seed_ranges = convert_seeds_to_seed_range( seeds_n_maps );
+
+			//for each range of seeds
+			for ( const auto& seeds : seed_ranges )
+			{
+				//set an active range to be mapping down to a location
+				std::vector<Range> active_ranges = {seeds};
+				//for each mapping stage
+				for ( const auto& maps : seeds_n_maps.conversion_map )
+				{
+					//keep track of converted ranges for the next set of active ranges
+					std::vector<Range> converted_ranges = {};
+					//for each active range we will map it to the next stage of the mapping pipeline
+					for ( auto& current_range : active_ranges )
+					{
+						//map the current range to the next stage of the pipeline
+						std::vector<Range> conversions = map_ranges( current_range, maps );
+						//append any converted ranges to keep track of conversions for each of the maps in this stage
+						converted_ranges.insert( converted_ranges.end(), conversions.begin(), conversions.end() );
+					}
+					//sort the converted ranges by starting location - sorting the list allows us to ensure that anything prior to the first matching mapped range is passed through
+					std::sort( converted_ranges.begin(), converted_ranges.end(), []( const Range& a, const Range& b ) { return a.start < b.start; } );
+					//change the active range to the converted range
+					active_ranges = converted_ranges;
+				}
+				//keep tabs on the lowest location value returned from the mapping process. fixed: a seed range of size 0 maps to no
+				//ranges and read past the end
+				if ( !active_ranges.empty() && active_ranges[0].start < lowest_location )
+				{
+					lowest_location = active_ranges[0].start;
+				}
+			}
+			return lowest_location;
+		}
+	}
+}
+
+Result aoc::day_05( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	const day_05::Seeds_Maps seed_n_maps = day_05::read_input( input );
+	//both parts look up the stages composed into one function
+	const day_05::Composed_Map composed = day_05::compose_stages( seed_n_maps.conversion_map );
+
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_answer = day_05::part_01( seed_n_maps, composed );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_05::part_02( seed_n_maps, composed );
+
+	timer::stop();
+	return { std::string( " 5: Mapping Ranges" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+
+}
+
+Result references::day_05( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	const day_05::Seeds_Maps seed_n_maps = day_05::read_input( input );
+
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_answer = day_05::reference::part_01( seed_n_maps );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_05::reference::part_02( seed_n_maps );
+
+	timer::stop();
+	return { std::string( " 5: Mapping Ranges" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+almanac::Composed_Map almanac::build( const std::string_view input )
+{
+	return day_05::compose_stages( day_05::read_input( input ).conversion_map );
+}
+
+Result almanac::solve_stage_ranges( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	const day_05::Seeds_Maps seed_n_maps = day_05::read_input( input );
+	const std::vector<day_05::Composed_Map> stages = day_05::stage_functions( seed_n_maps.conversion_map );
+	day_05::Range_Scratch scratch = {};
+	std::vector<size_t> interval_counts = {};
+
+	profiler::set_phase( "part_1" );
+	//each seed of part 1 is a range of one
+	std::vector<day_05::Range> seeds = {};
+	for ( const auto seed : seed_n_maps.seed_ids )
+	{
+		seeds.push_back( { seed, 1 } );
+	}
+	const uint64_t part_1_answer = day_05::map_stages( seeds, stages, scratch, interval_counts );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_05::map_stages( day_05::convert_seeds_to_seed_range( seed_n_maps ), stages, scratch, interval_counts );
+
+	timer::stop();
+	return { std::string( " 5: Mapping Ranges" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+almanac::Engine almanac::build_engine( const std::string_view input, const bool seed_ranges )
+{
+	const day_05::Seeds_Maps seed_n_maps = day_05::read_input( input );
+	Engine engine = day_05::new_engine( seed_n_maps.conversion_map.size() );
+	for ( size_t stage = 0; stage < seed_n_maps.conversion_map.size(); ++stage )
+	{
+		for ( const auto& map : seed_n_maps.conversion_map[stage] )
+		{
+			if ( map.range > 0 )
+			{
+				insert_rule( engine, stage, { map.destination, map.source, map.range } );
+			}
+		}
+	}
+	const std::vector<uint64_t>& seeds = seed_n_maps.seed_ids;
+	for ( size_t i = 0; i < seeds.size(); i += (seed_ranges ? 2 : 1) )
+	{
+		const uint64_t size = seed_ranges ? seeds[i + 1] : 1;
+		day_05::push_seeds( engine, 0, seeds[i], seeds[i] + size, 1 );
+	}
+	return engine;
+}
+
+void almanac::insert_rule( Engine& engine, const size_t stage, const Rule& rule )
+{
+	if ( stage >= engine.stages.size() )
+	{
+		throw std::invalid_argument( "the almanac has no such stage" );
+	}
+	if ( rule.range == 0 )
+	{
+		throw std::invalid_argument( "a rule must cover at least one value" );
+	}
+	std::map<uint64_t, Rule>& rules = engine.stages[stage].rules;
+	const auto next = rules.lower_bound( rule.source );
+	if ( (next != rules.end() && next->first < rule.source + rule.range) ||
+		 (next != rules.begin() && std::prev( next )->first + std::prev( next )->second.range > rule.source) )
+	{
+		throw std::invalid_argument( "a rule can't overlap another rule of its stage" );
+	}
+	rules.emplace_hint( next, rule.source, rule );
+	//the values under the rule passed through unchanged until now
+	day_05::move_seeds( engine, stage, rule.source, rule.source + rule.range, 0, rule.destination - rule.source );
+}
+
+void almanac::remove_rule( Engine& engine, const size_t stage, const uint64_t source )
+{
+	if ( stage >= engine.stages.size() )
+	{
+		throw std::invalid_argument( "the almanac has no such stage" );
+	}
+	std::map<uint64_t, Rule>& rules = engine.stages[stage].rules;
+	const auto found = rules.find( source );
+	if ( found == rules.end() )
+	{
+		throw std::invalid_argument( "the stage has no rule starting at that source" );
 	}
+	const Rule rule = found->second;
+	rules.erase( found );
+	day_05::move_seeds( engine, stage, rule.source, rule.source + rule.range, rule.destination - rule.source, 0 );
+}
 
+uint64_t almanac::lookup( const Engine& engine, uint64_t seed )
+{
+	for ( const auto& stage : engine.stages )
+	{
+		const auto rule = stage.rules.upper_bound( seed );
+		if ( rule != stage.rules.begin() && std::prev( rule )->second.source + std::prev( rule )->second.range > seed )
+		{
+			seed += std::prev( rule )->second.destination - std::prev( rule )->second.source;
+		}
+	}
+	return seed;
+}
 
+uint64_t almanac::lowest_location( const Engine& engine )
+{
+	//equal neighbouring steps are merged so a counted step is at most the second one
+	for ( const auto& [location, count] : engine.locations )
+	{
+		if ( count > 0 )
+		{
+			return location;
+		}
+	}
+	return UINT64_MAX;
 }
 
-Result aoc::day_05()
+Result almanac::solve_engine( const std::string_view input )
 {
 	timer::start();
-	day_05::Seeds_Maps seed_n_maps = day_05::read_input_file( "./input/day_05.txt" );
+	profiler::set_phase( "parse" );
+	const Engine values = build_engine( input, false );
+	const Engine ranges = build_engine( input, true );
 
-	const uint64_t part_1_answer = day_05::part_01( seed_n_maps );
-	const uint64_t part_2_answer = day_05::part_02( seed_n_maps );
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_answer = lowest_location( values );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = lowest_location( ranges );
 
 	timer::stop();
 	return { std::string( " 5: Mapping Ranges" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+uint64_t almanac::locate( const Composed_Map& map, const uint64_t* seeds, const size_t count, uint64_t* locations )
+{
+	constexpr size_t min_chunk_seeds = 1 << 14;
+	const size_t chunk_count = parallel::chunk_count( count, min_chunk_seeds );
+	std::vector<uint64_t> lowest( chunk_count, UINT64_MAX );
+	const cpu::Kernels& kernels = cpu::kernels();
+	parallel::for_each_index( chunk_count, [&]( const size_t chunk )
+							  {
+								  const size_t begin = chunk * count / chunk_count;
+								  const size_t end = (chunk + 1) * count / chunk_count;
+								  kernels.piecewise_lookup( map.starts.data(), map.offsets.data(), map.starts.size(), seeds + begin, end - begin, locations + begin );
+								  for ( size_t i = begin; i < end; ++i )
+								  {
+									  lowest[chunk] = std::min( lowest[chunk], locations[i] );
+								  }
+							  } );
+	return *std::min_element( lowest.begin(), lowest.end() );
+}
+
+std::vector<bench::Benchmark> benchmarks::day_05()
+{
+	std::mt19937_64 rng( 5 );
+	//a stage of non overlapping maps sorted by source with gaps between them, as read_input produces
+	std::vector<day_05::Map> maps = {};
+	uint64_t source = rng() % 1000;
+	for ( int i = 0; i < 40; ++i )
+	{
+		const uint64_t range = 1000 + rng() % 100000;
+		maps.push_back( { rng() % 4000000000ULL, source, range } );
+		source += range + rng() % 10000;
+	}
+	std::vector<day_05::Range> ranges = {};
+	for ( int i = 0; i < 1024; ++i )
+	{
+		ranges.push_back( { rng() % source, 1 + rng() % 200000 } );
+	}
+	const uint64_t batch_size = ranges.size();
+	//seven such stages composed, the lookup is one binary search over the breakpoints
+	std::vector<std::vector<day_05::Map>> conversion_map( 7, maps );
+	for ( auto& stage : conversion_map )
+	{
+		for ( auto& map : stage )
+		{
+			map.destination = rng() % source;
+		}
+	}
+	const day_05::Composed_Map composed = day_05::compose_stages( conversion_map );
+	std::vector<uint64_t> seeds( 1024 );
+	for ( auto& seed : seeds )
+	{
+		seed = rng() % source;
+	}
+	//a million seeds located in one batch, items/s is the seed throughput at the --threads count
+	std::vector<uint64_t> batch_seeds( 1 << 20 );
+	std::vector<uint64_t> locations( batch_seeds.size() );
+	for ( auto& seed : batch_seeds )
+	{
+		seed = rng() % source;
+	}
+	//an almanac with thousands of rules a stage, the label shows the ranges still active after each stage
+	std::vector<std::vector<day_05::Map>> large_conversion_map( 7 );
+	for ( auto& stage : large_conversion_map )
+	{
+		uint64_t large_source = rng() % 100000;
+		for ( int i = 0; i < 2000; ++i )
+		{
+			const uint64_t range = 1 + rng() % 2000000;
+			stage.push_back( { rng() % 4000000000ULL, large_source, range } );
+			large_source += range + ((rng() % 3 == 0) ? rng() % 500000 : 0);
+		}
+	}
+	const std::vector<day_05::Composed_Map> large_stages = day_05::stage_functions( large_conversion_map );
+	std::vector<day_05::Range> seed_ranges = {};
+	for ( int i = 0; i < 1024; ++i )
+	{
+		seed_ranges.push_back( { rng() % 4000000000ULL, 1 + rng() % 20000000 } );
+	}
+	day_05::Range_Scratch scratch = {};
+	std::vector<size_t> interval_counts = {};
+	day_05::map_stages( seed_ranges, large_stages, scratch, interval_counts );
+	std::string counts_label = "intervals";
+	for ( const auto count : interval_counts )
+	{
+		counts_label += " " + std::to_string( count );
+	}
+	const uint64_t seed_range_count = seed_ranges.size();
+	//tens of thousands of rules behind the engine, each edit takes a rule out and puts it back and asks for the lowest location
+	almanac::Engine engine = day_05::new_engine( 7 );
+	std::vector<std::pair<size_t, almanac::Rule>> edited_rules = {};
+	for ( size_t stage = 0; stage < engine.stages.size(); ++stage )
+	{
+		uint64_t rule_source = rng() % 100000;
+		for ( int i = 0; i < 5000; ++i )
+		{
+			const almanac::Rule rule = { rng() % 4000000000ULL, rule_source, 1 + rng() % 800000 };
+			almanac::insert_rule( engine, stage, rule );
+			if ( i % 50 == 0 )
+			{
+				edited_rules.push_back( { stage, rule } );
+			}
+			rule_source += rule.range + ((rng() % 3 == 0) ? rng() % 200000 : 0);
+		}
+	}
+	for ( int i = 0; i < 10; ++i )
+	{
+		const uint64_t start = rng() % 3000000000ULL;
+		day_05::push_seeds( engine, 0, start, start + 1 + rng() % 500000000ULL, 1 );
+	}
+	std::shuffle( edited_rules.begin(), edited_rules.end(), rng );
+	const uint64_t edit_count = 2 * edited_rules.size();
+	return {
+		{ "day_05::map_ranges/40_maps", batch_size, [stage = day_05::stage_function( maps ), ranges = std::move( ranges ), converted = std::vector<day_05::Range>()]() mutable
+		{
+			for ( const auto& range : ranges )
+			{
+				converted.clear();
+				day_05::map_ranges( range, stage, converted );
+				bench::do_not_optimize( converted.data() );
+			}
+		} },
+		{ "day_05::map_stages/7_stages_2000_maps", seed_range_count, [large_stages, seed_ranges = std::move( seed_ranges ), scratch = std::move( scratch ), interval_counts = std::move( interval_counts )]() mutable
+		{
+			bench::do_not_optimize( day_05::map_stages( seed_ranges, large_stages, scratch, interval_counts ) );
+		}, counts_label },
+		{ "day_05::edit_rule/7_stages_5000_rules", edit_count, [engine = std::move( engine ), edited_rules = std::move( edited_rules )]() mutable
+		{
+			for ( const auto& [stage, rule] : edited_rules )
+			{
+				almanac::remove_rule( engine, stage, rule.source );
+				bench::do_not_optimize( almanac::lowest_location( engine ) );
+				almanac::insert_rule( engine, stage, rule );
+				bench::do_not_optimize( almanac::lowest_location( engine ) );
+			}
+		} },
+		{ "day_05::lookup/7_stages_40_maps", seeds.size(), [composed, seeds = std::move( seeds )]()
+		{
+			for ( const auto seed : seeds )
+			{
+				bench::do_not_optimize( day_05::lookup( composed, seed ) );
+			}
+		} },
+		{ "day_05::locate/1m_seeds", batch_seeds.size(), [composed, batch_seeds = std::move( batch_seeds ), locations = std::move( locations )]() mutable
+		{
+			bench::do_not_optimize( almanac::locate( composed, batch_seeds.data(), batch_seeds.size(), locations.data() ) );
+		} },
+	};
+}
 
+std::string generators::day_05( const uint32_t seed )
+{
+	std::mt19937_64 rng( seed );
+	const char* stages[7] = { "seed-to-soil", "soil-to-fertilizer", "fertilizer-to-water", "water-to-light",
+							  "light-to-temperature", "temperature-to-humidity", "humidity-to-location" };
+	std::stringstream ss;
+	ss << "seeds:";
+	for ( int i = 0; i < 10; ++i )
+	{
+		ss << ' ' << rng() % 3000000000ULL << ' ' << 1 + rng() % 500000000ULL;
+	}
+	ss << "\n";
+	for ( const auto stage : stages )
+	{
+		//non overlapping source ranges with gaps, written in a random order
+		std::vector<day_05::Map> maps = {};
+		uint64_t source = rng() % 100000000ULL;
+		const uint32_t count = 10 + rng() % 30;
+		for ( uint32_t i = 0; i < count; ++i )
+		{
+			const uint64_t range = 1 + rng() % 200000000ULL;
+			maps.push_back( { rng() % 4000000000ULL, source, range } );
+			source += range + ((rng() % 3 == 0) ? rng() % 50000000ULL : 0);
+		}
+		std::shuffle( maps.begin(), maps.end(), rng );
+		ss << "\n" << stage << " map:\n";
+		for ( const auto& map : maps )
+		{
+			ss << map.destination << ' ' << map.source << ' ' << map.range << '\n';
+		}
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,15 +6,26 @@
 //\==============================================================================
 
 
+#include "bench.h"
+#include "boat_races.h"
+#include "cpu_dispatch.h"
 #include "days.h"
+#include "embedded.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
+#include <charconv>
+#include <cmath>
+#include <iomanip>
 #include <numeric>
+#include <random>
+#include <span>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -26,140 +37,271 @@ namespace day_06
 		uint64_t distance;
 	};
 
-	std::vector<Race> read_input_file( std::string input_file )
+	//the whitespace separated numbers on a line, everything up to the first digit is the line's label
+	constexpr std::vector<uint64_t> read_numbers( const std::string_view line )
 	{
-		std::vector<Race> races = {};
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		std::vector<uint64_t> numbers = {};
+		bool in_number = false;
+		uint64_t value = {};
+		for ( size_t i = line.find_first_of( "0123456789" ); i < line.size(); ++i )
 		{
-			//input file contains two lines race duration followed by race distance record
-			std::string race_times = {};
-			std::getline( file_input, race_times );
-			std::stringstream rs( race_times.substr(race_times.find_first_of("0123456789" ) ) );
-			
-			std::string race_distances = {};
-			std::getline( file_input, race_distances );
-			std::stringstream rd( race_distances.substr( race_distances.find_first_of( "0123456789" ) ) );
-
-			uint64_t time = {};
-			uint64_t distance = {};
-			//iterate over substrings and add races to the races vector
-			while( rs >> time )
+			if ( line[i] >= '0' && line[i] <= '9' )
 			{
-				rd >> distance; //file input guarantees that there are the same number of entries for races & distance so safety is off.
-				races.push_back( { time, distance } );
+				value = value * 10 + static_cast<uint64_t>(line[i] - '0');
+				in_number = true;
+			}
+			else if ( in_number )
+			{
+				numbers.push_back( value );
+				value = 0;
+				in_number = false;
 			}
-			file_input.close();
 		}
-		return races;
-	}
-
-	bool meets_win_conditions( const uint64_t speed, const uint64_t remaining_time, const uint64_t record )
-	{
-		const uint64_t distance_travelled = speed * remaining_time;
-		return distance_travelled > record;
+		if ( in_number )
+		{
+			numbers.push_back( value );
+		}
+		return numbers;
 	}
 
-	uint64_t find_win_time( Race race )
+	//constexpr so that the embedded input can be parsed by the compiler, a '\r' in front of a line's '\n' is
+	//passed over by read_numbers like any other separator
+	constexpr std::vector<Race> read_input( const std::string_view input )
 	{
-		uint64_t low = 0;
-		uint64_t high = race.time;
-		//start in the middle
-		uint64_t mid_point = (low + high) >> 1;
-		uint64_t winning_time = 0;
-		while ( winning_time == 0 )
+		std::vector<Race> races = {};
+		if ( !input.empty() )
 		{
-			//is this the minimum winning condition?
-			const uint64_t neighbouring_time = mid_point - 1;
-			const bool neighbouring_win = meets_win_conditions( neighbouring_time, race.time - neighbouring_time, race.distance );
-			const bool mid_point_win = meets_win_conditions( mid_point, race.time - mid_point, race.distance );
-			if ( !neighbouring_win && mid_point_win )
-			{
-				winning_time = mid_point;
-			}
-			else if ( !neighbouring_win && !mid_point_win ) //both losses move forward in time
-			{
-				low = mid_point;
-			}
-			else //both wins so look further towards beginning
+			//input file contains two lines race duration followed by race distance record
+			const size_t times_end = input.find( '\n' );
+			const std::vector<uint64_t> times = read_numbers( input.substr( 0, times_end ) );
+			const size_t distances_start = (times_end == std::string_view::npos) ? input.size() : times_end + 1;
+			const std::vector<uint64_t> distances = read_numbers( input.substr( distances_start, input.find( '\n', distances_start ) - distances_start ) );
+			//file input guarantees that there are the same number of entries for races & distance
+			for ( size_t i = 0; i < times.size() && i < distances.size(); ++i )
 			{
-				high = mid_point ;
+				races.push_back( { times[i], distances[i] } );
 			}
-			mid_point = (low + high) >> 1;
-			if ( mid_point == 0 || mid_point > race.time ) { break; }
 		}
-		return winning_time;
+		return races;
 	}
 
-	uint64_t calc_winning_range( Race race )
+#if AOC_EMBED_INPUTS
+	constexpr auto embedded_races = embedded::to_array<read_input( embedded::input( 6 ) ).size()>( []() { return read_input( embedded::input( 6 ) ); } );
+#endif
+
+	//races from the embedded input were parsed when the program was built, anything else is parsed now into storage
+	std::span<const Race> get_races( const std::string_view input, std::vector<Race>& storage )
 	{
-		//use quadratic formula to find point parabola crosses the x axis if we treat race time as b and c as race distance (+1 to beat the distance)
-		const double discriminant = sqrt( race.time * race.time - 4 * (race.distance + 1) );
-		//determinant is just 2 as a value resolves to 1.
-		const auto min = static_cast<uint64_t>(ceil((static_cast<double>(race.time) - discriminant)/2.0));
-		const auto max = static_cast<uint64_t>(floor( (static_cast<double>(race.time) + discriminant)/2.0 ));
-		return max - min + 1;
+#if AOC_EMBED_INPUTS
+		if ( embedded::is_embedded( input, 6 ) )
+		{
+			return embedded_races;
+		}
+#endif
+		storage = read_input( input );
+		return storage;
 	}
 
-	
-	uint64_t part_01( const std::vector<Race>& races )
+	uint64_t part_01( const std::span<const Race> races )
 	{
 		//To see how much margin of error you have, determine the number of ways you can beat the record in each race
-		//Initial thought is to utlilise a binary search to find the lowest point that satisfies
-		//winning condition then find upper point that satisfies winning condition then take range
 		//returns multiplicitave of winning ranges
-		std::vector<uint64_t> num_ways_to_win = {};
-		for( const auto& race : races )
+		std::vector<uint64_t> times = {};
+		std::vector<uint64_t> distances = {};
+		for ( const auto& race : races )
 		{
-			const uint64_t calc_opportunity_count = calc_winning_range( race );
-			//const uint64_t min_time = find_win_time( race );
-			////It's a symmetric curve so sub min from total time.
-			//const uint64_t max_time = race.time - min_time;
-			//const uint64_t opportunity_count = max_time - min_time +1;
-			num_ways_to_win.push_back( calc_opportunity_count );
+			times.push_back( race.time );
+			distances.push_back( race.distance );
 		}
+		std::vector<uint64_t> num_ways_to_win( races.size() );
+		boat_races::count_wins( times.data(), distances.data(), races.size(), num_ways_to_win.data() );
 		return std::accumulate( num_ways_to_win.begin(), num_ways_to_win.end(), 1LLU, std::multiplies<>() );
 	}
 
-	uint64_t part_02( const std::vector<Race>& races )
+	//append the decimal digits of value to joined, throws std::invalid_argument if the result doesn't fit in 64 bits
+	uint64_t join_digits( uint64_t joined, const uint64_t value )
+	{
+		char digits[20] = {};
+		const char* end = std::to_chars( std::begin( digits ), std::end( digits ), value ).ptr;
+		for ( const char* digit = digits; digit != end; ++digit )
+		{
+			const auto digit_value = static_cast<uint64_t>(*digit - '0');
+			if ( joined > (UINT64_MAX - digit_value) / 10 )
+			{
+				throw std::invalid_argument( "the joined up race doesn't fit in 64 bits" );
+			}
+			joined = joined * 10 + digit_value;
+		}
+		return joined;
+	}
+
+	uint64_t part_02( const std::span<const Race> races )
 	{
 		//There was a kerning error - wouldn't you know it, lousy input.
 		//There is only one race, and one distance to beat so combine input into a single race.
-		std::stringstream rt;
-		std::stringstream rd;
-		for ( const auto& race : races )
+		Race race = {};
+		for ( const auto& part : races )
 		{
-			rt << race.time;
-			rd << race.distance;
+			race.time = join_digits( race.time, part.time );
+			race.distance = join_digits( race.distance, part.distance );
 		}
-		uint64_t race_time = {};
-		uint64_t race_distance = {};
-		rt >> race_time;
-		rd >> race_distance;
-		Race race = { race_time, race_distance };
-
-		const uint64_t opportunity_count = calc_winning_range( race );
-
-		//const uint64_t min_time = find_win_time( race );
-		////It's a symmetric curve so sub min from total time.
-		//const uint64_t max_time = race.time - min_time;
-		//const uint64_t opportunity_count = max_time - min_time + 1;
+		uint64_t opportunity_count = {};
+		boat_races::count_wins( &race.time, &race.distance, 1, &opportunity_count );
 		return opportunity_count;
 	}
 
+	/**
+	 * @brief the solver as it was before the win counts moved onto the exact integer root,
+	 *        kept as the registry's reference so --check compares the rewrite against it
+	 */
+	namespace reference
+	{
+		uint64_t calc_winning_range( Race race )
+		{
+			//use quadratic formula to find point parabola crosses the x axis if we treat race time as b and c as race distance (+1 to beat the distance)
+			const double discriminant = sqrt( race.time * race.time - 4 * (race.distance + 1) );
+			//determinant is just 2 as a value resolves to 1.
+			const auto min = static_cast<uint64_t>(ceil((static_cast<double>(race.time) - discriminant)/2.0));
+			const auto max = static_cast<uint64_t>(floor( (static_cast<double>(race.time) + discriminant)/2.0 ));
+			return max - min + 1;
+		}
+
+		uint64_t part_01( const std::span<const Race> races )
+		{
+			//To see how much margin of error you have, determine the number of ways you can beat the record in each race
+			//returns multiplicitave of winning ranges
+			std::vector<uint64_t> num_ways_to_win = {};
+			for( const auto& race : races )
+			{
+				num_ways_to_win.push_back( calc_winning_range( race ) );
+			}
+			return std::accumulate( num_ways_to_win.begin(), num_ways_to_win.end(), 1LLU, std::multiplies<>() );
+		}
 
+		uint64_t part_02( const std::span<const Race> races )
+		{
+			//There is only one race, and one distance to beat so combine input into a single race.
+			std::stringstream rt;
+			std::stringstream rd;
+			for ( const auto& race : races )
+			{
+				rt << race.time;
+				rd << race.distance;
+			}
+			uint64_t race_time = {};
+			uint64_t race_distance = {};
+			rt >> race_time;
+			rd >> race_distance;
+			return calc_winning_range( { race_time, race_distance } );
+		}
+	}
 }
 
-Result aoc::day_06()
+Result aoc::day_06( const std::string_view input )
 {
 	timer::start();
-	std::vector<day_06::Race> races = day_06::read_input_file( "./input/day_06.txt" );
+	profiler::set_phase( "parse" );
+	std::vector<day_06::Race> parsed_races = {};
+	const std::span<const day_06::Race> races = day_06::get_races( input, parsed_races );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_06::part_01( races );
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_06::part_02( races );
 
 	timer::stop();
 	return { std::string( " 6: Boat Races" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+Result references::day_06( const std::string_view input )
+{
+	timer::start();
+	profiler::set_phase( "parse" );
+	std::vector<day_06::Race> parsed_races = {};
+	const std::span<const day_06::Race> races = day_06::get_races( input, parsed_races );
+
+	profiler::set_phase( "part_1" );
+	const uint64_t part_1_answer = day_06::reference::part_01( races );
+	profiler::set_phase( "part_2" );
+	const uint64_t part_2_answer = day_06::reference::part_02( races );
+
+	timer::stop();
+	return { std::string( " 6: Boat Races" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
+}
+
+void boat_races::count_wins( const uint64_t* times, const uint64_t* distances, const size_t count, uint64_t* wins )
+{
+	constexpr size_t min_chunk_races = 1 << 16;
+	const size_t chunk_count = parallel::chunk_count( count, min_chunk_races );
+	const cpu::Kernels& kernels = cpu::kernels();
+	parallel::for_each_index( chunk_count, [&]( const size_t chunk )
+							  {
+								  const size_t begin = chunk * count / chunk_count;
+								  const size_t end = (chunk + 1) * count / chunk_count;
+								  kernels.race_wins( times + begin, distances + begin, end - begin, wins + begin );
+							  } );
+}
+
+std::vector<bench::Benchmark> benchmarks::day_06()
+{
+	std::mt19937_64 rng( 6 );
+	//a million races of puzzle scale, every one is solved in the vector lanes
+	std::vector<uint64_t> times( 1 << 20 );
+	std::vector<uint64_t> distances( times.size() );
+	for ( size_t i = 0; i < times.size(); ++i )
+	{
+		times[i] = 1 + rng() % 100000;
+		distances[i] = rng() % ((times[i] / 2) * (times[i] - times[i] / 2) + 1);
+	}
+	//and a million with 64 bit times and records, every one takes the exact integer root
+	std::vector<uint64_t> wide_times( times.size() );
+	std::vector<uint64_t> wide_distances( times.size() );
+	for ( size_t i = 0; i < wide_times.size(); ++i )
+	{
+		wide_times[i] = rng() | (1ULL << 63);
+		wide_distances[i] = rng();
+	}
+	std::vector<uint64_t> wins( times.size() );
+	const uint64_t race_count = times.size();
+	return {
+		{ "day_06::count_wins/1m_races", race_count, [times = std::move( times ), distances = std::move( distances ), wins]() mutable
+		{
+			boat_races::count_wins( times.data(), distances.data(), times.size(), wins.data() );
+			bench::do_not_optimize( wins.data() );
+		} },
+		{ "day_06::count_wins/1m_races_64_bit", race_count, [wide_times = std::move( wide_times ), wide_distances = std::move( wide_distances ), wins = std::move( wins )]() mutable
+		{
+			boat_races::count_wins( wide_times.data(), wide_distances.data(), wide_times.size(), wins.data() );
+			bench::do_not_optimize( wins.data() );
+		} },
+	};
+}
+
+std::string generators::day_06( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	//race times of two digits and records of up to three digits keep the joined up part 2 race within 64 bits
+	std::vector<uint64_t> times = {};
+	std::vector<uint64_t> distances = {};
+	for ( int i = 0; i < 4; ++i )
+	{
+		const uint64_t time = 40 + rng() % 60;
+		const uint64_t best = std::min<uint64_t>( 999, (time / 2) * (time - time / 2) - 1 );
+		times.push_back( time );
+		distances.push_back( time + rng() % (best - time) );
+	}
+	std::stringstream ss;
+	ss << "Time:    ";
+	for ( const auto time : times )
+	{
+		ss << ' ' << std::setw( 4 ) << time;
+	}
+	ss << "\nDistance:";
+	for ( const auto distance : distances )
+	{
+		ss << ' ' << std::setw( 4 ) << distance;
+	}
+	ss << '\n';
+	return ss.str();
 }
\ No newline at end of file
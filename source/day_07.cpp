@@ -6,14 +6,17 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
 #include <numeric>
+#include <random>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -84,15 +87,14 @@ namespace day_07
 		
 	}
 
-	std::vector<Hand> read_input_file( std::string input_file )
+	std::vector<Hand> read_input( const std::string_view input )
 	{
 		std::vector<Hand> hands = {};
 		//file is a series of lines made up of hand info and bit amount
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -135,7 +137,6 @@ namespace day_07
 					hands.push_back( { hand, bid, win_type } );
 				}
 			}
-			file_input.close();
 		}
 		return hands;
 	}
@@ -213,15 +214,46 @@ namespace day_07
 	
 }
 
-Result aoc::day_07()
+Result aoc::day_07( const std::string_view input )
 {
 	timer::start();
-	std::vector<day_07::Hand> hands = day_07::read_input_file( "./input/day_07.txt" );
+	profiler::set_phase( "parse" );
+	std::vector<day_07::Hand> hands = day_07::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = part_01(hands);
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = part_02( hands );
 
 	timer::stop();
 	return { std::string( " 7: Camel Cards" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::string generators::day_07( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	const std::string cards = "23456789TJQKA";
+	//hands are unique so the ranking never depends on the order equal hands were sorted into
+	std::set<std::string> hands = {};
+	while ( hands.size() < 1000 )
+	{
+		std::string hand( 5, ' ' );
+		//draw from a few cards some of the time so that pairs, full houses and jokers turn up often
+		const uint32_t variety = 2 + rng() % 12;
+		for ( auto& c : hand )
+		{
+			c = cards[rng() % variety];
+		}
+		std::shuffle( hand.begin(), hand.end(), rng );
+		hands.insert( hand );
+	}
+	std::vector<std::string> shuffled( hands.begin(), hands.end() );
+	std::shuffle( shuffled.begin(), shuffled.end(), rng );
+	std::stringstream ss;
+	for ( const auto& hand : shuffled )
+	{
+		ss << hand << ' ' << 1 + rng() % 999 << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,12 +6,13 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
 
 
-#include <fstream>
 #include <map>
 #include <numeric>
 #include <ranges>
@@ -27,18 +28,17 @@ namespace day_08
 		std::map<std::string, std::pair<std::string, std::string>> parent_children;
 	};
 
-	Map read_input_file( std::string input_file )
+	Map read_input( const std::string_view input )
 	{
 		std::string directions;
 		std::map<std::string, std::pair<std::string, std::string>> parent_children;
 		//file is a series of lines made up of hand info and bit amount
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
 			//The first line is the directions
-			std::getline( file_input, directions );
-			for ( std::string line; std::getline( file_input, line ); )
+			std::getline( input_stream, directions );
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -52,7 +52,6 @@ namespace day_08
 				}
 	
 			}
-			file_input.close();
 		}
 		return {directions, parent_children};
 	}
@@ -119,12 +118,15 @@ namespace day_08
 
 }
 
-Result aoc::day_08()
+Result aoc::day_08( const std::string_view input )
 {
 	timer::start();
-	day_08::Map map = day_08::read_input_file( "./input/day_08.txt" );
+	profiler::set_phase( "parse" );
+	day_08::Map map = day_08::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = part_01( map );
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = part_02( map );
 
 	timer::stop();
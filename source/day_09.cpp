@@ -6,15 +6,17 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
 #include <map>
 #include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -27,18 +29,17 @@ namespace day_09
 		std::vector<std::vector<int64_t>> differences;
 	};
 
-	std::vector<Reading> read_input_file( const std::string& input_file )
+	std::vector<Reading> read_input( const std::string_view input )
 	{
 		std::vector<Reading> readings = {};
 		std::string directions;
 		std::map<std::string, std::pair<std::string, std::string>> parent_children;
 		//file is a series of lines made up of hand info and bit amount
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
 			//The first line is the directions
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -69,7 +70,6 @@ namespace day_09
 				}
 
 			}
-			file_input.close();
 		}
 		return readings;
 	}
@@ -112,15 +112,45 @@ namespace day_09
 
 }
 
-Result aoc::day_09()
+Result aoc::day_09( const std::string_view input )
 {
 	timer::start();
-	std::vector<day_09::Reading> readings = day_09::read_input_file( "./input/day_09.txt" );
+	profiler::set_phase( "parse" );
+	std::vector<day_09::Reading> readings = day_09::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_09::part_01( readings );
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_09::part_02( readings );
 
 	timer::stop();
 	return { std::string( " 9: OASIS Predictions" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::string generators::day_09( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	//readings are polynomials of up to degree five sampled at 0..20 so the differences always reach zero
+	std::stringstream ss;
+	for ( int line = 0; line < 200; ++line )
+	{
+		const uint32_t degree = rng() % 6;
+		std::vector<int64_t> coefficients = {};
+		for ( uint32_t d = 0; d <= degree; ++d )
+		{
+			coefficients.push_back( static_cast<int64_t>(rng() % 21) - 10 );
+		}
+		for ( int64_t x = 0; x <= 20; ++x )
+		{
+			int64_t value = {};
+			for ( auto c = coefficients.rbegin(); c != coefficients.rend(); ++c )
+			{
+				value = value * x + *c;
+			}
+			ss << ((x == 0) ? "" : " ") << value;
+		}
+		ss << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,13 +6,13 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
 #include <map>
 #include <string>
 #include <vector>
@@ -39,17 +39,16 @@ namespace day_10
 		int32_t height;
 	};
 
-	Map read_input_file( const std::string& input_file )
+	Map read_input( const std::string_view input )
 	{
 		std::vector<std::string> map_data = {};
 		Map_Location start_point = {};
 		//file is a 2D map of x by y with symbols 'F, 7, L, J, -, | ' for pipes and . for empty space
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
 			//The first line is the directions
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -61,7 +60,6 @@ namespace day_10
 					}
 				}
 			}
-			file_input.close();
 		}
 		return {map_data, start_point, static_cast<int32_t>(map_data[0].size()), static_cast<int32_t>(map_data.size()) };
 	}
@@ -206,15 +204,18 @@ namespace day_10
 
 }
 
-Result aoc::day_10()
+Result aoc::day_10( const std::string_view input )
 {
 	timer::start();
-	day_10::Map map = day_10::read_input_file( "./input/day_10.txt" );
+	profiler::set_phase( "parse" );
+	day_10::Map map = day_10::read_input( input );
 	//locate the main loop within the input data
 	std::vector<day_10::Map_Location> main_loop = locate_main_loop( map );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_10::part_01( main_loop );
 	
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_10::part_02( main_loop, map );
 
 	timer::stop();
@@ -6,15 +6,18 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
 #include <map>
 #include <numeric>
+#include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -34,21 +37,20 @@ namespace day_11
 		
 	};
 
-	Input_Map read_input_file( const std::string& input_file )
+	Input_Map read_input( const std::string_view input )
 	{
 		std::vector<Galaxy_Location> galaxy_locations = {};
 		std::vector<uint64_t> x_offsets = {};
 		std::vector<uint64_t> y_offsets = {};
 
 		//file is a 2D map of x by y with symbols '#' for galaxies and '.' for empty space
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
 			uint64_t y_position = {};
 			uint64_t y_offset = {};
 			std::string blank_columns = {};
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -85,7 +87,6 @@ namespace day_11
 				}
 				x_offsets.push_back( x_offset );
 			}
-			file_input.close();
 		}
 
 		//we now have a vector of all galaxy locations and two vectors of offset amounts in x and y directions
@@ -135,16 +136,49 @@ namespace day_11
 
 }
 
-Result aoc::day_11()
+Result aoc::day_11( const std::string_view input )
 {
 	timer::start();
-	const day_11::Input_Map galaxy_locations = day_11::read_input_file( "./input/day_11.txt" );
+	profiler::set_phase( "parse" );
+	const day_11::Input_Map galaxy_locations = day_11::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_11::part_01( galaxy_locations );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_11::part_02( galaxy_locations );
 
 	timer::stop();
 	return { std::string( "11: Galaxy Maps" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::string generators::day_11( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	std::vector<std::string> image( 140, std::string( 140, '.' ) );
+	//leave a handful of rows and columns empty for the expansion
+	std::vector<bool> empty_rows( 140, false );
+	std::vector<bool> empty_columns( 140, false );
+	for ( int i = 0; i < 10; ++i )
+	{
+		empty_rows[rng() % 140] = true;
+		empty_columns[rng() % 140] = true;
+	}
+	for ( size_t y = 0; y < image.size(); ++y )
+	{
+		for ( size_t x = 0; x < image[y].size(); ++x )
+		{
+			if ( !empty_rows[y] && !empty_columns[x] && rng() % 50 == 0 )
+			{
+				image[y][x] = '#';
+			}
+		}
+	}
+	std::stringstream ss;
+	for ( const auto& row : image )
+	{
+		ss << row << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,16 +6,20 @@
 //\==============================================================================
 
 
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
 #include <map>
 #include <numeric>
 #include <string>
+#include <random>
 #include <sstream>
 #include <vector>
 
@@ -27,14 +31,13 @@ namespace day_12
 		std::vector<uint32_t> groups;
 	};
 
-	std::vector<Spring_Group> read_input_file( const std::string& input_file )
+	std::vector<Spring_Group> read_input( const std::string_view input )
 	{
 		std::vector<Spring_Group> spring_groups;
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -54,7 +57,6 @@ namespace day_12
 					spring_groups.push_back( { springs, groups } );
 				}
 			}			
-			file_input.close();
 		}
 		return spring_groups;
 	}
@@ -179,13 +181,13 @@ namespace day_12
 				group.insert( group.end(), dupe_group.begin(), dupe_group.end() );
 			}
 		}
-		std::vector<uint64_t> possibilities = {};
-		
-		for ( const auto& spring_group : unwrapped )
-		{
-			std::map< std::pair<uint64_t, uint64_t>, uint64_t> cached_values = {};
-			possibilities.push_back( process_pattern( spring_group, 0, 0, cached_values ) );
-		}
+		//each row has its own cache so the rows can be counted on separate threads
+		std::vector<uint64_t> possibilities( unwrapped.size(), 0 );
+		parallel::for_each_index( unwrapped.size(), [&]( const size_t i )
+								  {
+									  std::map< std::pair<uint64_t, uint64_t>, uint64_t> cached_values = {};
+									  possibilities[i] = process_pattern( unwrapped[i], 0, 0, cached_values );
+								  } );
 
 		return std::accumulate( possibilities.begin(), possibilities.end(), 0LLU );
 	}
@@ -193,16 +195,97 @@ namespace day_12
 
 }
 
-Result aoc::day_12()
+Result aoc::day_12( const std::string_view input )
 {
 	timer::start();
-	const std::vector< day_12::Spring_Group> spring_groups = day_12::read_input_file( "./input/day_12.txt" );
+	profiler::set_phase( "parse" );
+	const std::vector< day_12::Spring_Group> spring_groups = day_12::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_12::part_01( spring_groups );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_12::part_02( spring_groups );
 
 	timer::stop();
 	return { std::string( "12: Spring Permutations" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_12()
+{
+	std::mt19937 rng( 12 );
+	//build a random row of springs, record its groups then hide some springs behind '?' and unfold it like part 2
+	std::vector<day_12::Spring_Group> spring_groups = {};
+	for ( int i = 0; i < 64; ++i )
+	{
+		std::string springs( 10 + rng() % 10, '.' );
+		for ( auto& c : springs )
+		{
+			c = (rng() % 3 == 0) ? '#' : '.';
+		}
+		std::vector<uint32_t> groups = {};
+		uint32_t run = {};
+		for ( const auto c : springs + '.' )
+		{
+			if ( c == '#' ) { ++run; continue; }
+			if ( run != 0 ) { groups.push_back( run ); run = 0; }
+		}
+		for ( auto& c : springs )
+		{
+			c = (rng() % 5 < 2) ? '?' : c;
+		}
+		day_12::Spring_Group unfolded = { springs, groups };
+		for ( int u = 0; u < 4; ++u )
+		{
+			unfolded.springs += '?' + springs;
+			unfolded.groups.insert( unfolded.groups.end(), groups.begin(), groups.end() );
+		}
+		spring_groups.push_back( unfolded );
+	}
+	const uint64_t batch_size = spring_groups.size();
+	return {
+		{ "day_12::process_pattern/unfolded", batch_size, [spring_groups = std::move( spring_groups )]()
+		{
+			for ( const auto& spring_group : spring_groups )
+			{
+				std::map< std::pair<uint64_t, uint64_t>, uint64_t> cached_values = {};
+				bench::do_not_optimize( day_12::process_pattern( spring_group, 0, 0, cached_values ) );
+			}
+		} },
+	};
+}
+
+std::string generators::day_12( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	//build a row of springs, record its groups then hide some of the springs behind '?'
+	std::stringstream ss;
+	for ( int line = 0; line < 1000; ++line )
+	{
+		std::string springs( 1 + rng() % 20, '.' );
+		for ( auto& c : springs )
+		{
+			c = (rng() % 3 == 0) ? '#' : '.';
+		}
+		springs[rng() % springs.size()] = '#';
+		std::vector<uint32_t> groups = {};
+		uint32_t run = {};
+		for ( const auto c : springs + '.' )
+		{
+			if ( c == '#' ) { ++run; continue; }
+			if ( run != 0 ) { groups.push_back( run ); run = 0; }
+		}
+		for ( auto& c : springs )
+		{
+			c = (rng() % 5 < 2) ? '?' : c;
+		}
+		ss << springs << ' ';
+		for ( size_t g = 0; g < groups.size(); ++g )
+		{
+			ss << ((g == 0) ? "" : ",") << groups[g];
+		}
+		ss << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,13 +6,15 @@
 //\==============================================================================
 
 
+#include "buffer.h"
 #include "days.h"
+#include "cpu_dispatch.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
 
 #include <algorithm>
 #include <bitset>
-#include <fstream>
 #include <string>
 #include <vector>
 
@@ -44,15 +46,14 @@ namespace day_13
 		return rotated;
 	}
 	
-	std::vector<AshMap> read_input_file( const std::string& input_file )
+	std::vector<AshMap> read_input( const std::string_view input )
 	{
 		std::vector<AshMap> ash_maps;
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
 			std::vector<std::string> map;
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -68,7 +69,6 @@ namespace day_13
 			}
 			const auto rotated = rotate_map_data( map );
 			ash_maps.push_back( { map, rotated, -1, -1 } );
-			file_input.close();
 		}
 
 		return ash_maps;
@@ -78,6 +78,7 @@ namespace day_13
 	// current reflection point is passed in as part 2 needs this as there should be a different point.
 	int32_t find_reflection( const std::vector<std::string>& map_data, int32_t current_reflection_point )
 	{
+		const cpu::Kernels& kernels = cpu::kernels();
 		for( int row = 0; row < map_data.size(); ++row )
 		{
 			int current_row = row;
@@ -85,7 +86,9 @@ namespace day_13
 			bool are_same = false;
 			while ( current_row >= 0 && next_row < map_data.size() )
 			{
-				are_same = (map_data[current_row] == map_data[next_row]);
+				const std::string& current = map_data[current_row];
+				const std::string& next = map_data[next_row];
+				are_same = current.size() == next.size() && kernels.rows_equal( current.data(), next.data(), current.size() );
 				if( are_same )
 				{
 					if( current_reflection_point == (row+1) ) //already found this point look for another further on
@@ -217,13 +220,16 @@ namespace day_13
 
 }
 
-Result aoc::day_13()
+Result aoc::day_13( const std::string_view input )
 {
 	timer::start();
-	std::vector< day_13::AshMap> ash_maps = day_13::read_input_file( "./input/day_13.txt" );
+	profiler::set_phase( "parse" );
+	std::vector< day_13::AshMap> ash_maps = day_13::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_13::part_01( ash_maps );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_13::part_02( ash_maps );
 
 	timer::stop();
@@ -6,29 +6,33 @@
 //\==============================================================================
 
 
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
 #include <algorithm>
 #include <bitset>
-#include <fstream>
-#include <iostream>
 #include <map>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
 namespace day_14
 {
 	
-	std::vector<std::string> read_input_file( const std::string& input_file )
+	std::vector<std::string> read_input( const std::string_view input )
 	{
 		std::vector<std::string> map;
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
@@ -36,22 +40,11 @@ namespace day_14
 					map.push_back( line );
 				}
 			}
-			file_input.close();
 		}
 
 		return map;
 	}
 
-	void print_map( std::vector<std::string> map )
-	{
-		std::cout << std::endl;
-		for ( auto row : map )
-		{
-			std::cout << row << std::endl;
-		}
-		std::cout << std::endl;
-	}
-
 	void move_north( std::vector<std::string>& map )
 	{
 		std::vector<int32_t> movement_vector( map[0].length(), 0 );
@@ -141,7 +134,6 @@ namespace day_14
 	
 	uint64_t part_01( std::vector<std::string>& map )
 	{
-		//print_map(map);
 		move_north( map );
 		// now go through the map and calculate load
 		uint64_t row_load = map.size();
@@ -209,16 +201,70 @@ namespace day_14
 
 }
 
-Result aoc::day_14()
+Result aoc::day_14( const std::string_view input )
 {
 	timer::start();
-	std::vector<std::string> map = day_14::read_input_file( "./input/day_14.txt" );
+	profiler::set_phase( "parse" );
+	std::vector<std::string> map = day_14::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_14::part_01( map );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_14::part_02( map, 1000000000 );
 
 	timer::stop();
 	return { std::string( "14: Rock n Roll!" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_14()
+{
+	std::mt19937 rng( 14 );
+	std::vector<std::string> pristine( 100, std::string( 100, '.' ) );
+	for ( auto& row : pristine )
+	{
+		for ( auto& c : row )
+		{
+			const uint32_t r = rng() % 10;
+			c = (r < 2) ? 'O' : (r < 3) ? '#' : '.';
+		}
+	}
+	//each batch resets the board before tilting it, assigning into the existing rows is a copy without any allocation
+	const auto make_benchmark = [&pristine]( const std::string& name, void (*move)(std::vector<std::string>&) ) -> bench::Benchmark
+	{
+		auto working = std::make_shared<std::vector<std::string>>( pristine );
+		return { name, 1, [pristine, working, move]()
+		{
+			for ( size_t r = 0; r < pristine.size(); ++r )
+			{
+				(*working)[r].assign( pristine[r] );
+			}
+			move( *working );
+			bench::do_not_optimize( working->data() );
+		} };
+	};
+	return {
+		make_benchmark( "day_14::move_north/100x100", day_14::move_north ),
+		make_benchmark( "day_14::move_west/100x100", day_14::move_west ),
+		make_benchmark( "day_14::move_south/100x100", day_14::move_south ),
+		make_benchmark( "day_14::move_east/100x100", day_14::move_east ),
+	};
+}
+
+std::string generators::day_14( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	std::stringstream ss;
+	for ( int y = 0; y < 100; ++y )
+	{
+		std::string row( 100, '.' );
+		for ( auto& c : row )
+		{
+			const uint32_t r = rng() % 10;
+			c = (r < 2) ? 'O' : (r < 3) ? '#' : '.';
+		}
+		ss << row << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,13 +6,19 @@
 //\==============================================================================
 
 
+#include "bench.h"
 #include "days.h"
+#include "cpu_dispatch.h"
+#include "embedded.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
-#include <fstream>
 #include <numeric>
+#include <random>
 #include <ranges>
+#include <span>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -20,45 +26,50 @@
 namespace day_15
 {
 
-	std::vector<std::string> read_input_file( const std::string& input_file )
+	//steps are views into the input, split on ',' and line ends. constexpr so that the embedded input can be split by the compiler,
+	//which sees it before buffer::normalise_line_ends could so a '\r' ends a step as well
+	constexpr std::vector<std::string_view> read_input( const std::string_view input )
 	{
-		std::vector<std::string> steps;
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		std::vector<std::string_view> steps;
+		size_t step_start = 0;
+		for ( size_t i = 0; i <= input.size(); ++i )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			if ( i == input.size() || input[i] == ',' || input[i] == '\n' || input[i] == '\r' )
 			{
-				if ( line.length() > 0 )
+				if ( i > step_start )
 				{
-					std::string set_string{};
-					std::stringstream input_stream( line );
-					//split the input string on the ';' character
-					while ( std::getline( input_stream, set_string, ',' ) )
-					{
-						steps.push_back( set_string );
-					}
+					steps.push_back( input.substr( step_start, i - step_start ) );
 				}
+				step_start = i + 1;
 			}
-			file_input.close();
 		}
-
 		return steps;
 	}
 
-	uint64_t Holiday_ASCII_String_Helper( const std::string& str )
+#if AOC_EMBED_INPUTS
+	constexpr auto embedded_steps = embedded::to_array<read_input( embedded::input( 15 ) ).size()>( []() { return read_input( embedded::input( 15 ) ); } );
+#endif
+
+	//steps of the embedded input were split when the program was built, anything else is split now into storage
+	std::span<const std::string_view> get_steps( const std::string_view input, std::vector<std::string_view>& storage )
 	{
-		uint64_t v = 0;
-		for ( const auto& c : str )
+#if AOC_EMBED_INPUTS
+		if ( embedded::is_embedded( input, 15 ) )
 		{
-			v += static_cast<uint64_t>(c);
-			v *= 17;
-			v %= 256;			
+			return embedded_steps;
 		}
-		return v;
+#endif
+		storage = read_input( input );
+		return storage;
+	}
+
+	uint64_t Holiday_ASCII_String_Helper( const std::string_view str )
+	{
+		//hash is (v + c) * 17 % 256 for each character, see simd_kernels.cpp for the vector versions
+		return cpu::kernels().holiday_hash( str.data(), str.size() );
 	}
 	
-	uint64_t part_01( const std::vector<std::string>& steps )
+	uint64_t part_01( const std::span<const std::string_view> steps )
 	{
 		std::vector<uint64_t> hashed_steps = {};
 		for( const auto& step : steps )
@@ -70,7 +81,7 @@ namespace day_15
 
 	
 
-	uint64_t part_02( const std::vector<std::string>& steps )
+	uint64_t part_02( const std::span<const std::string_view> steps )
 	{
 		struct Box
 		{
@@ -82,7 +93,7 @@ namespace day_15
 		for ( const auto& step : steps )
 		{
 			//find the first instance of '=' or '-' in the step
-			std::string lens_id = step.substr( 0, step.find_first_of("-=" ));
+			std::string lens_id = std::string( step.substr( 0, step.find_first_of( "-=" ) ) );
 			const uint64_t box_id = Holiday_ASCII_String_Helper( lens_id );
 			//if string contains a digit add it to the box if not remove the
 			auto& lenses = boxes[box_id].lenses;
@@ -117,16 +128,97 @@ namespace day_15
 
 }
 
-Result aoc::day_15()
+Result aoc::day_15( const std::string_view input )
 {
 	timer::start();
-	const std::vector<std::string> hash_steps = day_15::read_input_file( "./input/day_15.txt" );
+	profiler::set_phase( "parse" );
+	std::vector<std::string_view> parsed_steps = {};
+	const std::span<const std::string_view> hash_steps = day_15::get_steps( input, parsed_steps );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_15::part_01( hash_steps );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_15::part_02( hash_steps );
 
 	timer::stop();
 	return { std::string( "15: Hash Function" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_15()
+{
+	std::mt19937 rng( 15 );
+	//lens steps are short labels followed by an operation e.g. "rn=1" or "cm-"
+	std::vector<std::string> steps = {};
+	for ( int i = 0; i < 4096; ++i )
+	{
+		std::string step( 2 + rng() % 5, 'a' );
+		for ( auto& c : step )
+		{
+			c = static_cast<char>('a' + rng() % 26);
+		}
+		step += (rng() % 2 == 0) ? std::string( "-" ) : "=" + std::to_string( 1 + rng() % 9 );
+		steps.push_back( step );
+	}
+	//long strings exercise the vector paths of the hash kernel
+	std::vector<std::string> long_strings = {};
+	for ( int i = 0; i < 64; ++i )
+	{
+		std::string str( 4096, 'a' );
+		for ( auto& c : str )
+		{
+			c = static_cast<char>(' ' + rng() % 95);
+		}
+		long_strings.push_back( str );
+	}
+	const uint64_t steps_size = steps.size();
+	const uint64_t long_size = long_strings.size();
+	return {
+		{ "day_15::Holiday_ASCII_String_Helper/steps", steps_size, [steps = std::move( steps )]()
+		{
+			for ( const auto& step : steps )
+			{
+				bench::do_not_optimize( day_15::Holiday_ASCII_String_Helper( step ) );
+			}
+		} },
+		{ "day_15::Holiday_ASCII_String_Helper/4k", long_size, [long_strings = std::move( long_strings )]()
+		{
+			for ( const auto& str : long_strings )
+			{
+				bench::do_not_optimize( day_15::Holiday_ASCII_String_Helper( str ) );
+			}
+		} },
+	};
+}
+
+std::string generators::day_15( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	//a smaller pool of labels than steps so that lenses get replaced and removed as well as added
+	std::vector<std::string> labels = {};
+	for ( int i = 0; i < 500; ++i )
+	{
+		std::string label( 2 + rng() % 5, 'a' );
+		for ( auto& c : label )
+		{
+			c = static_cast<char>('a' + rng() % 26);
+		}
+		labels.push_back( label );
+	}
+	std::stringstream ss;
+	for ( int step = 0; step < 4000; ++step )
+	{
+		ss << ((step == 0) ? "" : ",") << labels[rng() % labels.size()];
+		if ( rng() % 3 == 0 )
+		{
+			ss << '-';
+		}
+		else
+		{
+			ss << '=' << 1 + rng() % 9;
+		}
+	}
+	ss << '\n';
+	return ss.str();
 }
\ No newline at end of file
@@ -6,13 +6,19 @@
 //\==============================================================================
 
 
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
-#include <fstream>
+#include <algorithm>
 #include <numeric>
 #include <queue>
+#include <random>
 #include <ranges>
 #include <string>
 #include <sstream>
@@ -21,21 +27,19 @@
 namespace day_16
 {
 
-	std::vector<std::string> read_input_file( const std::string& input_file )
+	std::vector<std::string> read_input( const std::string_view input )
 	{
 		std::vector<std::string> map;
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
 					map.push_back( line );
 				}
 			}
-			file_input.close();
 		}
 		return map;
 	}
@@ -252,54 +256,89 @@ namespace day_16
 	uint64_t part_02( const std::vector<std::string>& map )
 	{
 		//light can start in any edge location
-		uint64_t max_sum = {};
 		const auto map_width = static_cast<int32_t>(map[0].length());
 		const auto map_height = static_cast<int32_t>(map.size());
+		std::vector<Light> entry_lights = {};
 		//for top row heading south & bottom row heading north
 		for ( int32_t x = 0; x < map_width; ++x )
 		{
-			uint64_t sum = sum_visited_tiles( navigate_maze( { {x,0}, SOUTH }, map ) );
-			if( sum > max_sum )
-			{
-				max_sum = sum;
-			}
-			sum = sum_visited_tiles( navigate_maze( { {x,map_height-1}, NORTH }, map ) );
-			if ( sum > max_sum )
-			{
-				max_sum = sum;
-			}
+			entry_lights.push_back( { {x,0}, SOUTH } );
+			entry_lights.push_back( { {x,map_height-1}, NORTH } );
 		}
 		//for left column heading west & right column heading east
 		for ( int32_t y = 0; y < map_height; ++y )
 		{
-			uint64_t sum = sum_visited_tiles( navigate_maze( { {0,y}, EAST }, map ) );
-			if ( sum > max_sum )
-			{
-				max_sum = sum;
-			}
-			sum = sum_visited_tiles( navigate_maze( { {map_width-1,y}, WEST }, map ) );
-			if ( sum > max_sum )
-			{
-				max_sum = sum;
-			}
+			entry_lights.push_back( { {0,y}, EAST } );
+			entry_lights.push_back( { {map_width-1,y}, WEST } );
 		}
-
-		return max_sum;
+		//every entry point is independent so they can be traced on separate threads
+		std::vector<uint64_t> sums( entry_lights.size(), 0 );
+		parallel::for_each_index( entry_lights.size(), [&]( const size_t i )
+								  {
+									  sums[i] = sum_visited_tiles( navigate_maze( entry_lights[i], map ) );
+								  } );
+		return *std::max_element( sums.begin(), sums.end() );
 	}
 
 
 }
 
-Result aoc::day_16()
+Result aoc::day_16( const std::string_view input )
 {
 	timer::start();
-	const std::vector<std::string> map = day_16::read_input_file( "./input/day_16.txt" );
+	profiler::set_phase( "parse" );
+	const std::vector<std::string> map = day_16::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_16::part_01( map );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_16::part_02( map );
 
 	timer::stop();
 	return { std::string( "16: Light Maze" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_16()
+{
+	std::mt19937 rng( 16 );
+	//same size as the puzzle input, mostly empty space with scattered mirrors and splitters
+	const std::string tiles = "/\\|-";
+	std::vector<std::string> map( 110, std::string( 110, '.' ) );
+	for ( auto& row : map )
+	{
+		for ( auto& c : row )
+		{
+			c = (rng() % 10 == 0) ? tiles[rng() % tiles.size()] : '.';
+		}
+	}
+	constexpr uint64_t batch_size = 16;
+	return {
+		{ "day_16::navigate_maze/110x110", batch_size, [map = std::move( map )]()
+		{
+			//enter from evenly spaced points along the top edge
+			for ( int32_t i = 0; i < static_cast<int32_t>(batch_size); ++i )
+			{
+				bench::do_not_optimize( day_16::navigate_maze( { { i * 7, 0 }, day_16::SOUTH }, map ) );
+			}
+		} },
+	};
+}
+
+std::string generators::day_16( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	const std::string tiles = "/\\|-";
+	std::stringstream ss;
+	for ( int y = 0; y < 110; ++y )
+	{
+		std::string row( 110, '.' );
+		for ( auto& c : row )
+		{
+			c = (rng() % 10 == 0) ? tiles[rng() % tiles.size()] : '.';
+		}
+		ss << row << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,14 +6,18 @@
 //\==============================================================================
 
 
+#include "bench.h"
+#include "buffer.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
 
-#include <fstream>
-#include <iostream>
 #include <queue>
+#include <random>
 #include <ranges>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -23,31 +27,29 @@ namespace day_17
 
 	using Map = std::vector<std::vector<uint32_t>>;
 
-	uint32_t map_width = {};
-	uint32_t map_height = {};
+	thread_local uint32_t map_width = {};
+	thread_local uint32_t map_height = {};
 
-	Map read_input_file( const std::string& input_file )
+	Map read_input( const std::string_view input )
 	{
 		Map map = {};
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		buffer::Stream input_stream( input );
+		if ( !input.empty() )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			for ( std::string line; std::getline( input_stream, line ); )
 			{
 				if ( line.length() > 0 )
 				{
 					std::vector<uint32_t> map_row;
 					for( const auto c : line )
 					{
-						map_row.push_back( std::atoi(&c) );
+						map_row.push_back( static_cast<uint32_t>(c - '0') );
 					}
 					map.push_back( map_row );
 				}				
 			}
 			map_width = static_cast<uint32_t>(map[0].size());
 			map_height = static_cast<uint32_t>(map.size());
-			file_input.close();
 		}
 		return map;
 	}
@@ -202,16 +204,75 @@ namespace day_17
 
 }
 
-Result aoc::day_17()
+Result aoc::day_17( const std::string_view input )
 {
 	timer::start();
-	const day_17::Map map = day_17::read_input_file( "./input/day_17.txt" );
+	profiler::set_phase( "parse" );
+	const day_17::Map map = day_17::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_17::part_01( map );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_17::part_02( map );
 
 	timer::stop();
 	return { std::string( "17: Dijkstra's Lava" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_17()
+{
+	std::mt19937 rng( 17 );
+	//get_neighbour_states reads the map size from the globals read_input sets
+	day_17::map_width = 141;
+	day_17::map_height = 141;
+	day_17::Map map( day_17::map_height, std::vector<uint32_t>( day_17::map_width ) );
+	for ( auto& row : map )
+	{
+		for ( auto& cost : row )
+		{
+			cost = 1 + rng() % 9;
+		}
+	}
+	const day_17::V2 directions[4] = { { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 } };
+	std::vector<std::pair<uint64_t, day_17::State>> states = {};
+	for ( int i = 0; i < 4096; ++i )
+	{
+		const day_17::V2 pos = { static_cast<int32_t>(rng() % day_17::map_width), static_cast<int32_t>(rng() % day_17::map_height) };
+		states.emplace_back( rng() % 1000, day_17::State{ pos, directions[rng() % 4], static_cast<uint32_t>(1 + rng() % 10) } );
+	}
+	const uint64_t batch_size = states.size();
+	return {
+		{ "day_17::get_neighbour_states/crucible", batch_size, [map, states]()
+		{
+			for ( const auto& state : states )
+			{
+				bench::do_not_optimize( day_17::get_neighbour_states( state, map, 0, 3 ) );
+			}
+		} },
+		{ "day_17::get_neighbour_states/ultra_crucible", batch_size, [map, states]()
+		{
+			for ( const auto& state : states )
+			{
+				bench::do_not_optimize( day_17::get_neighbour_states( state, map, 4, 10 ) );
+			}
+		} },
+	};
+}
+
+std::string generators::day_17( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	std::stringstream ss;
+	for ( int y = 0; y < 141; ++y )
+	{
+		std::string row( 141, '1' );
+		for ( auto& c : row )
+		{
+			c = static_cast<char>('1' + rng() % 9);
+		}
+		ss << row << '\n';
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -7,16 +7,22 @@
 
 
 #include "days.h"
+#include "embedded.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
+#include "structural.h"
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <iomanip>
 #include <map>
 #include <numeric>
 #include <queue>
+#include <random>
 #include <ranges>
 #include <set>
+#include <span>
 #include <string>
 #include <sstream>
 #include <unordered_map>
@@ -28,31 +34,33 @@ namespace day_18
 	{
 		int64_t x;
 		int64_t y;
-		bool operator ==( const V2& r ) const
+		constexpr bool operator ==( const V2& r ) const
 		{
 			return (x == r.x && y == r.y);
 		}
 
-		V2& operator +=( const V2& r )
+		constexpr V2& operator +=( const V2& r )
 		{
 			x += r.x; y += r.y;
 			return *this;
 		}
 
-		V2 operator *( const int64_t s ) const
+		constexpr V2 operator *( const int64_t s ) const
 		{
 			return { x * s, y * s };
 		}
 	};
 
+	//the colour is decoded when the instruction is read, its first five hex digits are the part 2 distance and the last is the direction
 	struct Instruction
 	{
 		V2 direction;
 		int64_t distance;
-		std::string color;
+		V2 colour_direction;
+		int64_t colour_distance;
 	};
 
-	V2 get_direction( const char c )
+	constexpr V2 get_direction( const char c )
 	{
 		switch(c)
 		{
@@ -63,33 +71,84 @@ namespace day_18
 		}
 	}
 
-	std::vector<Instruction> read_input_file( const std::string& input_file )
+	constexpr int64_t hex_digit( const char c )
+	{
+		return (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0;
+	}
+
+	//a line is "R 6 (#70c710)", brace_pos is the offset of the '('
+	constexpr Instruction read_instruction( const std::string_view line, const size_t brace_pos )
+	{
+		//read first character convert to direction
+		Instruction instruction = { get_direction( line[0] ), 0, { 1, 0 }, 0 };
+		for ( size_t i = 2; i < brace_pos && line[i] >= '0' && line[i] <= '9'; ++i )
+		{
+			instruction.distance = instruction.distance * 10 + (line[i] - '0');
+		}
+		const std::string_view colour = line.substr( std::min( brace_pos + 2, line.size() ), 6 );
+		for ( size_t i = 0; i + 1 < colour.size(); ++i )
+		{
+			instruction.colour_distance = instruction.colour_distance * 16 + hex_digit( colour[i] );
+		}
+		if ( !colour.empty() )
+		{
+			instruction.colour_direction = get_direction( colour.back() );
+		}
+		return instruction;
+	}
+
+	std::vector<Instruction> read_input( const std::string_view input )
 	{
 		std::vector<Instruction> instructions = {};
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		const structural::Index index = structural::build( input );
+		for ( size_t l = 0; l < structural::line_count( index ); ++l )
 		{
-			for ( std::string line; std::getline( file_input, line ); )
+			const std::string_view line = structural::line( index, l );
+			if ( line.length() > 0 )
 			{
-				if ( line.length() > 0 )
-				{
-					//read first character convert to direction
-					const V2 direction = get_direction( line[0] );
-					int64_t distance = {};
-					std::string color = {};
-					std::size_t brace_pos = line.find_first_of( '(' );
-					std::stringstream( line.substr( 2, brace_pos ) ) >> distance;
-
-					std::stringstream( line.substr(brace_pos+2, 6 ) ) >> color;
-					instructions.push_back( { direction, distance, color } );
-				}
+				//the index holds the '(' in front of the colour
+				instructions.push_back( read_instruction( line, structural::find_in_line( index, l ) ) );
 			}
-			file_input.close();
 		}
 		return instructions;
 	}
 
+#if AOC_EMBED_INPUTS
+	//the structural index isn't available to the compiler so the constexpr parse finds the '(' itself
+	constexpr std::vector<Instruction> read_embedded_input( const std::string_view input )
+	{
+		std::vector<Instruction> instructions = {};
+		for ( size_t line_start = 0; line_start < input.size(); )
+		{
+			const size_t line_end = std::min( input.find( '\n', line_start ), input.size() );
+			//the embedded input hasn't been through buffer::normalise_line_ends, a "\r\n" line end stops at the '\r'
+			const size_t line_length = line_end - line_start - ((line_end > line_start && input[line_end - 1] == '\r') ? 1 : 0);
+			const std::string_view line = input.substr( line_start, line_length );
+			if ( line.length() > 0 )
+			{
+				instructions.push_back( read_instruction( line, line.find( '(' ) ) );
+			}
+			line_start = line_end + 1;
+		}
+		return instructions;
+	}
+
+	constexpr auto embedded_instructions = embedded::to_array<read_embedded_input( embedded::input( 18 ) ).size()>( []() { return read_embedded_input( embedded::input( 18 ) ); } );
+#endif
+
+	//instructions from the embedded input were parsed when the program was built, anything else is parsed now into storage
+	std::span<const Instruction> get_instructions( const std::string_view input, std::vector<Instruction>& storage )
+	{
+#if AOC_EMBED_INPUTS
+		if ( embedded::is_embedded( input, 18 ) )
+		{
+			return embedded_instructions;
+		}
+#endif
+		storage = read_input( input );
+		return storage;
+	}
+
 	uint64_t shoelace( const std::vector<V2>& vertices )
 	{
 		int64_t left = {}; int64_t right = {};
@@ -101,12 +160,12 @@ namespace day_18
 		return abs(left - right) >> 1;
 	}
 
-	uint64_t part_01( const std::vector<Instruction>& instructions )
+	uint64_t part_01( const std::span<const Instruction> instructions )
 	{
 		//work out the volume of a shape from it's vertices
 		V2 pos = { 0,0 };
 		std::vector<V2> vertices = {1, pos};
-		for ( const auto& [direction, distance, color] : instructions )
+		for ( const auto& [direction, distance, colour_direction, colour_distance] : instructions )
 		{
 			pos += (direction * distance);
 			vertices.push_back( pos );
@@ -124,24 +183,16 @@ namespace day_18
 		return shoelace( vertices ) + perimeter / 2 + 1;
 	}
 
-	uint64_t part_02( const std::vector<Instruction>& instructions )
+	uint64_t part_02( const std::span<const Instruction> instructions )
 	{
 		//instructions were wrong as elves are, well.... elves.
-		//convert colour parameter of instructions to dig code first 5 values are distance to dig, last digit is direction
-		std::vector<Instruction> decoded_instructions = {};
-		for( const auto& [direction, distance, color] : instructions )
-		{
-			int64_t decoded_distance = {};
-			std::stringstream( color.substr( 0, color.length() - 1 ) ) >> std::hex >> decoded_distance;
-			const V2 decoded_dir = get_direction( color[color.length() - 1] );
-			decoded_instructions.push_back( { decoded_dir, decoded_distance, color } );
-		}
+		//the colour parameter of each instruction is the real dig code, read_instruction has already decoded it
 		//work out the volume of a shape from it's vertices
 		V2 pos = { 0,0 };
 		std::vector<V2> vertices = { 1, pos };
-		for ( const auto& [direction, distance, color] : decoded_instructions )
+		for ( const auto& [direction, distance, colour_direction, colour_distance] : instructions )
 		{
-			pos += (direction * distance);
+			pos += (colour_direction * colour_distance);
 			vertices.push_back( pos );
 		}
 		//make sure start and end points are the same
@@ -149,9 +200,9 @@ namespace day_18
 		{
 			vertices.push_back( vertices[0] );
 		}
-		const uint64_t perimeter = std::accumulate( decoded_instructions.begin(), decoded_instructions.end(), 0, []( uint64_t total, const Instruction& i )
+		const uint64_t perimeter = std::accumulate( instructions.begin(), instructions.end(), 0, []( uint64_t total, const Instruction& i )
 													{
-														return	total += static_cast<uint64_t>(i.distance);
+														return	total += static_cast<uint64_t>(i.colour_distance);
 													} );
 
 		return shoelace( vertices ) + perimeter / 2 + 1;
@@ -160,16 +211,66 @@ namespace day_18
 
 }
 
-Result aoc::day_18()
+Result aoc::day_18( const std::string_view input )
 {
 	timer::start();
-	const std::vector<day_18::Instruction> instructions = day_18::read_input_file( "./input/day_18.txt" );
+	profiler::set_phase( "parse" );
+	std::vector<day_18::Instruction> parsed_instructions = {};
+	const std::span<const day_18::Instruction> instructions = day_18::get_instructions( input, parsed_instructions );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_18::part_01( instructions );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_18::part_02( instructions );
 
 	timer::stop();
 	return { std::string( "18: Diggin' a Lava Pit!" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::string generators::day_18( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	//both dig plans trace the outline of a histogram, along the bottom, up the right hand side then back over the
+	//tops of the columns to the start, which can't cross itself. They have the same number of columns so that
+	//each line can carry a step of both plans.
+	const auto histogram = [&rng]( const uint32_t columns, const uint32_t max_size ) -> std::vector<std::pair<char, uint32_t>>
+	{
+		std::vector<uint32_t> widths = {};
+		std::vector<uint32_t> heights = {};
+		uint32_t total_width = {};
+		for ( uint32_t c = 0; c < columns; ++c )
+		{
+			widths.push_back( 1 + rng() % max_size );
+			//neighbouring columns never share a height so every step of the outline moves
+			uint32_t height = 1 + rng() % max_size;
+			while ( !heights.empty() && height == heights.back() )
+			{
+				height = 1 + rng() % max_size;
+			}
+			heights.push_back( height );
+			total_width += widths.back();
+		}
+		std::vector<std::pair<char, uint32_t>> steps = { { 'R', total_width }, { 'U', heights.back() } };
+		for ( uint32_t c = columns - 1; c > 0; --c )
+		{
+			steps.emplace_back( 'L', widths[c] );
+			steps.emplace_back( (heights[c - 1] > heights[c]) ? 'U' : 'D', (heights[c - 1] > heights[c]) ? heights[c - 1] - heights[c] : heights[c] - heights[c - 1] );
+		}
+		steps.emplace_back( 'L', widths[0] );
+		steps.emplace_back( 'D', heights[0] );
+		return steps;
+	};
+	const uint32_t columns = 50 + rng() % 100;
+	const auto plan = histogram( columns, 10 );
+	const auto colour_plan = histogram( columns, 100000 );
+	const std::string directions = "RDLU";
+	std::stringstream ss;
+	for ( size_t i = 0; i < plan.size(); ++i )
+	{
+		ss << plan[i].first << ' ' << plan[i].second << " (#" << std::hex << std::setw( 5 ) << std::setfill( '0' ) << colour_plan[i].second
+			<< std::dec << directions.find( colour_plan[i].first ) << ")\n";
+	}
+	return ss.str();
 }
\ No newline at end of file
@@ -6,15 +6,19 @@
 //\==============================================================================
 
 
+#include "bench.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "solvers.h"
+#include "structural.h"
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
 #include <map>
 #include <numeric>
 #include <queue>
+#include <random>
 #include <ranges>
 #include <set>
 #include <string>
@@ -65,13 +69,13 @@ namespace day_19
 
 
 
-	std::string process_workflow_string( const std::string& line, Workflow& workflow )
+	//brace_pos is the offset of the '{' in the line
+	std::string process_workflow_string( const std::string_view line, const size_t brace_pos, Workflow& workflow )
 	{
-		const size_t brace_pos = line.find( '{' );
-		std::string key = line.substr( 0, brace_pos );
+		std::string key = std::string( line.substr( 0, brace_pos ) );
 		//now get workflow
 		
-		std::string wf_str = line.substr( brace_pos+1, line.length()- (brace_pos + 2) );
+		std::string wf_str = std::string( line.substr( brace_pos+1, line.length()- (brace_pos + 2) ) );
 		// read to first ':' to get operator
 		size_t cp = 0;
 		size_t op_end_pos = wf_str.find( ':');
@@ -116,40 +120,37 @@ namespace day_19
 		return p;
 	}
 
-	Workflows_Parts read_input_file( const std::string& input_file )
+	Workflows_Parts read_input( const std::string_view input )
 	{
 		//set up containers for workflows and parts
 		std::map<std::string, Workflow> workflows;
 		std::vector<Part> parts;
 
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		const structural::Index index = structural::build( input );
+		bool processing_parts = false;
+		for ( size_t l = 0; l < structural::line_count( index ); ++l )
 		{
-			bool processing_parts = false;
-			for ( std::string line; std::getline( file_input, line ); )
+			const std::string_view line = structural::line( index, l );
+			if ( line.length() > 0 )
 			{
-				if ( line.length() > 0 )
+				if( !processing_parts )
 				{
-					if( !processing_parts )
-					{
-						//read in workflow
-						Workflow workflow = {};
-						std::string key = process_workflow_string( line, workflow );
-						workflows[key] = workflow;
-					}
-					else
-					{
-						Part part = extract_part_data( line );
-						parts.push_back( part );
-					}
+					//read in workflow, the first structural character on a workflow line is the '{' after its name
+					Workflow workflow = {};
+					std::string key = process_workflow_string( line, structural::find_in_line( index, l ), workflow );
+					workflows[key] = workflow;
 				}
 				else
 				{
-					processing_parts = true;
+					std::string part_line = std::string( line );
+					Part part = extract_part_data( part_line );
+					parts.push_back( part );
 				}
 			}
-			file_input.close();
+			else
+			{
+				processing_parts = true;
+			}
 		}
 		return {workflows, parts};
 	}
@@ -317,16 +318,112 @@ namespace day_19
 
 }
 
-Result aoc::day_19()
+Result aoc::day_19( const std::string_view input )
 {
 	timer::start();
-	day_19::Workflows_Parts instructions = day_19::read_input_file( "./input/day_19.txt" );
+	profiler::set_phase( "parse" );
+	day_19::Workflows_Parts instructions = day_19::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_19::part_01( instructions );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_19::part_02( instructions );
 
 	timer::stop();
 	return { std::string( "19: Sorting xmas Parts" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_19()
+{
+	std::mt19937 rng( 19 );
+	//workflows of one to four rules that send parts to other two or three letter workflows, or accept/reject them
+	const auto random_id = [&rng]() -> std::string
+	{
+		if ( rng() % 4 == 0 ) { return (rng() % 2 == 0) ? "A" : "R"; }
+		std::string id( 2 + rng() % 2, 'a' );
+		for ( auto& c : id )
+		{
+			c = static_cast<char>('a' + rng() % 26);
+		}
+		return id;
+	};
+	std::vector<day_19::Workflow> workflows = {};
+	for ( int i = 0; i < 256; ++i )
+	{
+		day_19::Workflow workflow = {};
+		const uint32_t rules = 1 + rng() % 4;
+		for ( uint32_t r = 0; r < rules; ++r )
+		{
+			workflow.operators.push_back( (rng() % 2 == 0) ? day_19::less_than : day_19::more_than );
+			workflow.op_results.push_back( random_id() );
+			workflow.part_index.push_back( static_cast<int32_t>(rng() % 4) );
+			workflow.value.push_back( static_cast<int32_t>(1 + rng() % 4000) );
+		}
+		workflow.op_results.push_back( random_id() );
+		workflows.push_back( workflow );
+	}
+	std::vector<day_19::Part> parts = {};
+	for ( int i = 0; i < 4096; ++i )
+	{
+		parts.push_back( { { static_cast<int32_t>(1 + rng() % 4000), static_cast<int32_t>(1 + rng() % 4000),
+							 static_cast<int32_t>(1 + rng() % 4000), static_cast<int32_t>(1 + rng() % 4000) } } );
+	}
+	const uint64_t batch_size = parts.size();
+	return {
+		{ "day_19::process_workflow", batch_size, [workflows = std::move( workflows ), parts = std::move( parts )]()
+		{
+			for ( size_t i = 0; i < parts.size(); ++i )
+			{
+				bench::do_not_optimize( day_19::process_workflow( parts[i], workflows[i % workflows.size()] ) );
+			}
+		} },
+	};
+}
+
+std::string generators::day_19( const uint32_t seed )
+{
+	std::mt19937 rng( seed );
+	//like the real input the workflows form a tree rooted at "in", each workflow is sent parts by exactly one rule
+	std::set<std::string> names = {};
+	while ( names.size() < 500 )
+	{
+		std::string name( 2 + rng() % 2, 'a' );
+		for ( auto& c : name )
+		{
+			c = static_cast<char>('a' + rng() % 26);
+		}
+		if ( name != "in" )
+		{
+			names.insert( name );
+		}
+	}
+	std::vector<std::string> ids = { "in" };
+	ids.insert( ids.end(), names.begin(), names.end() );
+	std::shuffle( ids.begin() + 1, ids.end(), rng );
+	size_t next_id = 1;
+	const auto destination = [&]() -> std::string
+	{
+		if ( next_id < ids.size() && rng() % 3 != 0 ) { return ids[next_id++]; }
+		return (rng() % 2 == 0) ? "A" : "R";
+	};
+	const std::string categories = "xmas";
+	std::stringstream ss;
+	for ( size_t i = 0; i < next_id; ++i )
+	{
+		ss << ids[i] << '{';
+		const uint32_t rules = 1 + rng() % 4;
+		for ( uint32_t r = 0; r < rules; ++r )
+		{
+			ss << categories[rng() % 4] << ((rng() % 2 == 0) ? '<' : '>') << 1 + rng() % 4000 << ':' << destination() << ',';
+		}
+		ss << destination() << "}\n";
+	}
+	ss << '\n';
+	for ( int part = 0; part < 200; ++part )
+	{
+		ss << "{x=" << 1 + rng() % 4000 << ",m=" << 1 + rng() % 4000 << ",a=" << 1 + rng() % 4000 << ",s=" << 1 + rng() % 4000 << "}\n";
+	}
+	return ss.str();
 }
\ No newline at end of file
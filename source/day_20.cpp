@@ -6,15 +6,18 @@
 //\==============================================================================
 
 
+#include "bench.h"
 #include "days.h"
+#include "profiler.h"
 #include "timer.h"
 #include "result.h"
+#include "structural.h"
 
-#include <fstream>
-#include <iostream>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <queue>
+#include <random>
 #include <ranges>
 #include <string>
 #include <sstream>
@@ -31,44 +34,39 @@ namespace day_20
 		char type;
 	};
 
-	std::map<std::string, Module> read_input_file( const std::string& input_file )
+	std::map<std::string, Module> read_input( const std::string_view input )
 	{
 		std::map<std::string, Module> configuration;
 		
-		std::ifstream file_input;
-		file_input.open( input_file );
-		if ( file_input.is_open() )
+		const structural::Index index = structural::build( input );
+		for ( size_t l = 0; l < structural::line_count( index ); ++l )
 		{
-			bool processing_parts = false;
-			for ( std::string line; std::getline( file_input, line ); )
+			const std::string_view line = structural::line( index, l );
+			if ( line.length() > 0 )
 			{
-				if ( line.length() > 0 )
+				//get the name and type of the module
+				const auto module_name_end = line.find_first_of( ' ' );
+				std::string name = std::string( line.substr( 0, module_name_end ) );
+				const char type = name[0];
+				if( type == '&' || type == '%' )
 				{
-					//get the name and type of the module
-					const auto module_name_end = line.find_first_of( ' ' );
-					std::string name = line.substr( 0, module_name_end );
-					const char type = name[0];
-					if( type == '&' || type == '%' )
-					{
-						//strip off type from name
-						name.erase( 0, 1 );
-					}
-					//get the destination modules from the line
-					const auto destination_location = line.find_first_of( '>' );
-					std::string destination_modules = line.substr( destination_location+1 );
-					//replace the ',' with space to make using stringstream more simple
-					std::ranges::replace( destination_modules.begin(), destination_modules.end(), ',', ' ' );
-					std::stringstream ss( destination_modules );
-					std::string destination_name = {};
-					std::vector<std::string> destinations;
-					while( ss >> destination_name )
-					{
-						destinations.push_back( destination_name );
-					}
-					configuration[name] = { name, destinations, {}, 0, type };
-				}				
-			}
-			file_input.close();
+					//strip off type from name
+					name.erase( 0, 1 );
+				}
+				//get the destination modules from the line, the index holds the '>' of the "->"
+				const auto destination_location = structural::find_in_line( index, l );
+				std::string destination_modules = std::string( line.substr( destination_location+1 ) );
+				//replace the ',' with space to make using stringstream more simple
+				std::ranges::replace( destination_modules.begin(), destination_modules.end(), ',', ' ' );
+				std::stringstream ss( destination_modules );
+				std::string destination_name = {};
+				std::vector<std::string> destinations;
+				while( ss >> destination_name )
+				{
+					destinations.push_back( destination_name );
+				}
+				configuration[name] = { name, destinations, {}, 0, type };
+			}				
 		}
 		// need to set up all input modules on conjunction modules
 		std::vector<Module*> conjunction_modules = {};
@@ -274,16 +272,81 @@ namespace day_20
 
 }
 
-Result aoc::day_20()
+Result aoc::day_20( const std::string_view input )
 {
 	timer::start();
-	std::map<std::string, day_20::Module> configuration = day_20::read_input_file( "./input/day_20.txt" );
+	profiler::set_phase( "parse" );
+	std::map<std::string, day_20::Module> configuration = day_20::read_input( input );
 
+	profiler::set_phase( "part_1" );
 	const uint64_t part_1_answer = day_20::part_01( configuration, 1000LLU );
 
+	profiler::set_phase( "part_2" );
 	const uint64_t part_2_answer = day_20::part_02( configuration );
 
 	timer::stop();
 	return { std::string( "20: Circuit Pulses" ), part_1_answer, part_2_answer, timer::get_elapsed_seconds() };
 
+}
+
+std::vector<bench::Benchmark> benchmarks::day_20()
+{
+	std::mt19937 rng( 20 );
+	//a puzzle sized circuit of flip flops and conjunctions wired to random destinations
+	auto configuration = std::make_shared<std::map<std::string, day_20::Module>>();
+	std::vector<std::string> names = {};
+	for ( int i = 0; i < 58; ++i )
+	{
+		names.push_back( { static_cast<char>('a' + i / 26), static_cast<char>('a' + i % 26) } );
+	}
+	for ( const auto& name : names )
+	{
+		std::vector<std::string> destinations = {};
+		const uint32_t count = 1 + rng() % 4;
+		for ( uint32_t d = 0; d < count; ++d )
+		{
+			destinations.push_back( names[rng() % names.size()] );
+		}
+		(*configuration)[name] = { name, destinations, {}, 0, (rng() % 4 == 0) ? '&' : '%' };
+	}
+	//wire up the conjunction inputs the same way read_input does
+	for ( auto& conjunction : std::views::values( *configuration ) )
+	{
+		if ( conjunction.type != '&' ) { continue; }
+		for ( const auto& module : std::views::values( *configuration ) )
+		{
+			for ( const auto& destination : module.destination_modules )
+			{
+				if ( destination == conjunction.name )
+				{
+					conjunction.connected_input_modules.emplace_back( std::make_pair( module.name, 0 ) );
+				}
+			}
+		}
+	}
+	//signals are sent from one of each module's real inputs so conjunction memory is exercised
+	struct Signal
+	{
+		day_20::Module* module;
+		uint32_t pulse;
+		std::string sender;
+	};
+	std::vector<Signal> signals = {};
+	for ( int i = 0; i < 4096; ++i )
+	{
+		day_20::Module* module = &(*configuration)[names[rng() % names.size()]];
+		const auto& inputs = module->connected_input_modules;
+		const std::string sender = inputs.empty() ? names[rng() % names.size()] : inputs[rng() % inputs.size()].first;
+		signals.push_back( { module, static_cast<uint32_t>(rng() % 2), sender } );
+	}
+	const uint64_t batch_size = signals.size();
+	return {
+		{ "day_20::process_signal", batch_size, [configuration, signals = std::move( signals )]()
+		{
+			for ( const auto& [module, pulse, sender] : signals )
+			{
+				bench::do_not_optimize( day_20::process_signal( module, pulse, sender, *configuration ) );
+			}
+		} },
+	};
 }
\ No newline at end of file
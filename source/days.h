@@ -1,27 +1,30 @@
 #pragma once
+#include <string_view>
+
 struct Result;
 
 namespace aoc
 {
-	extern Result day_01();
-	extern Result day_02();
-	extern Result day_03();
-	extern Result day_04();
-	extern Result day_05();
-	extern Result day_06();
-	extern Result day_07();
-	extern Result day_08();
-	extern Result day_09();
-	extern Result day_10();
-	extern Result day_11();
-	extern Result day_12();
-	extern Result day_13();
-	extern Result day_14();
-	extern Result day_15();
-	extern Result day_16();
-	extern Result day_17();
-	extern Result day_18();
-	extern Result day_19();
-	extern Result day_20();
+	//each day solves the puzzle input held in memory, the caller keeps it alive for the duration of the call
+	extern Result day_01( std::string_view input );
+	extern Result day_02( std::string_view input );
+	extern Result day_03( std::string_view input );
+	extern Result day_04( std::string_view input );
+	extern Result day_05( std::string_view input );
+	extern Result day_06( std::string_view input );
+	extern Result day_07( std::string_view input );
+	extern Result day_08( std::string_view input );
+	extern Result day_09( std::string_view input );
+	extern Result day_10( std::string_view input );
+	extern Result day_11( std::string_view input );
+	extern Result day_12( std::string_view input );
+	extern Result day_13( std::string_view input );
+	extern Result day_14( std::string_view input );
+	extern Result day_15( std::string_view input );
+	extern Result day_16( std::string_view input );
+	extern Result day_17( std::string_view input );
+	extern Result day_18( std::string_view input );
+	extern Result day_19( std::string_view input );
+	extern Result day_20( std::string_view input );
 		
 }
@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+//builds with AocEmbedInputs=true define AOC_EMBED_INPUTS and generate embedded_inputs.h from input/ before compiling
+#if AOC_EMBED_INPUTS
+#include "embedded_inputs.h"
+#endif
+
+/*
+ * Puzzle inputs compiled into the binary for fixed input deployments, startup doesn't open any
+ * files. Days with simple inputs also parse the embedded copy at compile time and only fall back
+ * to parsing at runtime when they are handed any other input.
+ */
+namespace embedded
+{
+#if AOC_EMBED_INPUTS
+	constexpr bool available = true;
+
+	inline constexpr std::array<std::string_view, 20> inputs = {
+		std::string_view( data::day_01, data::day_01_size ), std::string_view( data::day_02, data::day_02_size ),
+		std::string_view( data::day_03, data::day_03_size ), std::string_view( data::day_04, data::day_04_size ),
+		std::string_view( data::day_05, data::day_05_size ), std::string_view( data::day_06, data::day_06_size ),
+		std::string_view( data::day_07, data::day_07_size ), std::string_view( data::day_08, data::day_08_size ),
+		std::string_view( data::day_09, data::day_09_size ), std::string_view( data::day_10, data::day_10_size ),
+		std::string_view( data::day_11, data::day_11_size ), std::string_view( data::day_12, data::day_12_size ),
+		std::string_view( data::day_13, data::day_13_size ), std::string_view( data::day_14, data::day_14_size ),
+		std::string_view( data::day_15, data::day_15_size ), std::string_view( data::day_16, data::day_16_size ),
+		std::string_view( data::day_17, data::day_17_size ), std::string_view( data::day_18, data::day_18_size ),
+		std::string_view( data::day_19, data::day_19_size ), std::string_view( data::day_20, data::day_20_size ) };
+#else
+	constexpr bool available = false;
+
+	inline constexpr std::array<std::string_view, 20> inputs = {};
+#endif
+
+	//the input compiled in for a day (1 - 20), empty if inputs aren't embedded or the file was missing at build time
+	constexpr std::string_view input( const size_t day )
+	{
+		return inputs[day - 1];
+	}
+
+	//is this the embedded copy of the day's input rather than one read from a file
+	inline bool is_embedded( const std::string_view text, const size_t day )
+	{
+		return !input( day ).empty() && text.data() == input( day ).data() && text.size() == input( day ).size();
+	}
+
+	//a constexpr std::vector can't outlive constant evaluation, copy what parse returns into an array that can.
+	//count has to be parse().size()
+	template <size_t count, typename Parse>
+	constexpr auto to_array( const Parse parse )
+	{
+		const auto parsed = parse();
+		std::array<typename decltype(parsed)::value_type, count> values = {};
+		std::copy( parsed.begin(), parsed.end(), values.begin() );
+		return values;
+	}
+}
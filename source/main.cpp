@@ -1,14 +1,23 @@
 
 
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <vector>
 
+#include "batch.h"
+#include "buffer.h"
+#include "cpu_dispatch.h"
 #include "days.h"
+#include "embedded.h"
+#include "parallel.h"
+#include "profiler.h"
 #include "result.h"
+#include "solvers.h"
+#include "watch.h"
 
 
-std::vector< Result( * )() > questions = { aoc::day_01, aoc::day_02, aoc::day_03, aoc::day_04, aoc::day_05, aoc::day_06,
+std::vector< Result( * )( std::string_view ) > questions = { aoc::day_01, aoc::day_02, aoc::day_03, aoc::day_04, aoc::day_05, aoc::day_06,
 											aoc::day_07, aoc::day_08, aoc::day_09, aoc::day_10, aoc::day_11, aoc::day_12,
 											aoc::day_13, aoc::day_14, aoc::day_15, aoc::day_16, aoc::day_17, aoc::day_18,
 											aoc::day_19, aoc::day_20 };
@@ -98,17 +107,8 @@ void print_result(const Result& result )
 	print_separator();
 }
 
-int main( int argc, char* argv[] )
+void print_results_table( const std::vector<Result>& results )
 {
-	//Create a vector to store the results for each day's solutions
-	std::vector<Result> results = {};
-
-	for( const auto& question : questions )
-	{
-		results.push_back( question() );
-	}
-
-	//display results to console
 	print_break_to_console();
 	//print headings
 	print_heading_to_console();
@@ -118,8 +118,247 @@ int main( int argc, char* argv[] )
 		std::cout << std::endl;
 	}
 	print_break_to_console();
+	std::cout << "Kernels: " << cpu::isa_name( cpu::active_isa() ) << std::endl;
+}
 
+void print_profile_report( const std::vector<Result>& results, const std::vector<std::string>& day_labels, const std::string& directory )
+{
+	const std::vector<profiler::Day_Report> reports = profiler::get_reports();
+	uint64_t total_samples = {};
+	for ( const auto& report : reports )
+	{
+		total_samples += report.samples;
+	}
+	std::cout << "Profile: " << total_samples << " samples, " << profiler::dropped_samples() << " dropped, folded stacks written to " << directory << std::endl;
+	for ( const auto& report : reports )
+	{
+		//sampling overhead is the time spent in the signal handler compared to the time the day took to run
+		double day_time = {};
+		for ( size_t i = 0; i < day_labels.size() && i < results.size(); ++i )
+		{
+			if ( day_labels[i] == report.day )
+			{
+				day_time = results[i].execution_time;
+			}
+		}
+		const double overhead = (day_time > 0.0) ? 100.0 * report.handler_seconds / day_time : 0.0;
+		std::cout << "  " << std::left << std::setw( 14 ) << report.day << std::right
+			<< std::setw( 8 ) << report.samples << " samples  "
+			<< std::setw( 12 ) << report.handler_seconds << "s in handler  "
+			<< std::setw( 8 ) << std::setprecision( 3 ) << overhead << "% overhead" << std::setprecision( 6 ) << std::endl;
+	}
+}
+
+int main( int argc, char* argv[] )
+{
+	bool profile = false;
+	std::string profile_directory = "./profile";
+	uint32_t profile_interval = 1000;
+	bool check = false;
+	solvers::Check_Options check_options = { "./sample", "./check", 3, {} };
+	bool scaling = false;
+	solvers::Scaling_Options scaling_options = { "./input", parallel::thread_count(), 3, {} };
+	bool watching = false;
+	watch::Watch_Options watch_options = { "./input", 5, print_results_table };
+	bool batching = false;
+	batch::Batch_Options batch_options = { "./input", parallel::thread_count(), 1, batch::Mode::both, {} };
+
+	//process command line arguments
+	for ( int i = 1; i < argc; ++i )
+	{
+		const std::string argument = argv[i];
+		if ( argument.starts_with( "--isa=" ) )
+		{
+			//override the instruction set picked at startup so each kernel path can be benchmarked
+			cpu::Isa isa = {};
+			if ( !cpu::parse_isa( argument.substr( 6 ), isa ) )
+			{
+				std::cout << "Unknown instruction set '" << argument.substr( 6 ) << "' expected one of scalar, sse4.2, avx2, avx512" << std::endl;
+				return 1;
+			}
+			if ( !cpu::select( isa ) )
+			{
+				std::cout << "Instruction set '" << cpu::isa_name( isa ) << "' is not supported on this CPU (detected " << cpu::isa_name( cpu::detect() ) << ")" << std::endl;
+				return 1;
+			}
+		}
+		else if ( argument == "--profile" || argument.starts_with( "--profile=" ) )
+		{
+			//sample the call stacks of each day and write them out as folded stacks
+			profile = true;
+			if ( argument.size() > 10 )
+			{
+				profile_directory = argument.substr( 10 );
+			}
+		}
+		else if ( argument.starts_with( "--profile-interval=" ) )
+		{
+			//sampling interval in microseconds of cpu time
+			profile_interval = static_cast<uint32_t>(std::stoul( argument.substr( 19 ) ));
+		}
+		else if ( argument.starts_with( "--threads=" ) )
+		{
+			//threads used by the parallel parts of the solvers, defaults to the hardware concurrency
+			parallel::set_thread_count( static_cast<uint32_t>(std::stoul( argument.substr( 10 ) )) );
+		}
+		else if ( argument == "--scaling" || argument.starts_with( "--scaling=" ) )
+		{
+			//rerun the whole suite, or just the given day_XX, at 1, 2, 4 ... threads
+			scaling = true;
+			if ( argument.size() > 10 )
+			{
+				scaling_options.day = argument.substr( 10 );
+			}
+		}
+		else if ( argument.starts_with( "--scaling-threads=" ) )
+		{
+			scaling_options.max_threads = static_cast<uint32_t>(std::stoul( argument.substr( 18 ) ));
+		}
+		else if ( argument.starts_with( "--scaling-repetitions=" ) )
+		{
+			scaling_options.repetitions = static_cast<uint32_t>(std::stoul( argument.substr( 22 ) ));
+		}
+		else if ( argument == "--check" )
+		{
+			//run the reference and every optimised variant on the samples and generated inputs and diff the answers
+			check = true;
+		}
+		else if ( argument.starts_with( "--check-seeds=" ) )
+		{
+			check_options.seeds = static_cast<uint32_t>(std::stoul( argument.substr( 14 ) ));
+		}
+		else if ( argument.starts_with( "--check-day=" ) )
+		{
+			check_options.day = argument.substr( 12 );
+		}
+		else if ( argument == "--watch" || argument.starts_with( "--watch=" ) )
+		{
+			//keep running and re-solve a day whenever its input file in ./input (or the given directory) changes
+			watching = true;
+			if ( argument.size() > 8 )
+			{
+				watch_options.input_directory = argument.substr( 8 );
+			}
+		}
+		else if ( argument.starts_with( "--watch-settle=" ) )
+		{
+			//milliseconds to wait for further writes before re-solving
+			watch_options.settle_milliseconds = static_cast<uint32_t>(std::stoul( argument.substr( 15 ) ));
+		}
+		else if ( argument == "--batch" || argument.starts_with( "--batch=" ) )
+		{
+			//solve every day_XX*.txt in ./input (or the given directory) as a batch of jobs spread over worker threads and/or processes
+			batching = true;
+			if ( argument.size() > 8 )
+			{
+				batch_options.input_directory = argument.substr( 8 );
+			}
+		}
+		else if ( argument.starts_with( "--batch-workers=" ) )
+		{
+			batch_options.workers = static_cast<uint32_t>(std::stoul( argument.substr( 16 ) ));
+		}
+		else if ( argument.starts_with( "--batch-repeat=" ) )
+		{
+			batch_options.repeat = static_cast<uint32_t>(std::stoul( argument.substr( 15 ) ));
+		}
+		else if ( argument.starts_with( "--batch-mode=" ) )
+		{
+			if ( !batch::parse_mode( argument.substr( 13 ), batch_options.mode ) )
+			{
+				std::cout << "Unknown batch mode '" << argument.substr( 13 ) << "' expected one of threads, processes, both" << std::endl;
+				return 1;
+			}
+		}
+		else if ( argument.starts_with( "--batch-day=" ) )
+		{
+			batch_options.day = argument.substr( 12 );
+		}
+		else
+		{
+			std::cout << "Unknown argument '" << argument << "'" << std::endl;
+			return 1;
+		}
+	}
+
+	if ( check )
+	{
+		return solvers::check( check_options ) ? 0 : 1;
+	}
+	if ( scaling )
+	{
+		return solvers::scaling_sweep( scaling_options ) ? 0 : 1;
+	}
+	if ( batching )
+	{
+		return batch::run( batch_options ) ? 0 : 1;
+	}
+	if ( watching )
+	{
+		if ( !watch::run( watch_options ) )
+		{
+			std::cout << (watch::is_supported() ? "Unable to watch " + watch_options.input_directory : std::string( "--watch is not supported on this platform" )) << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	//labels used to attribute profile samples to each day
+	std::vector<std::string> day_labels = {};
+	for ( size_t i = 0; i < questions.size(); ++i )
+	{
+		std::stringstream ss;
+		ss << "day_" << std::setw( 2 ) << std::setfill( '0' ) << (i + 1);
+		day_labels.push_back( ss.str() );
+	}
+	if ( profile && !profiler::start( profile_interval ) )
+	{
+		std::cout << (profiler::is_supported() ? "Unable to start the sampling profiler" : "--profile is not supported on this platform") << std::endl;
+		return 1;
+	}
+
+	//Create a vector to store the results for each day's solutions
+	std::vector<Result> results = {};
+
+	for( size_t i = 0; i < questions.size(); ++i )
+	{
+		//builds with embedded inputs only go to the input directory for days that had no input when they were built.
+		//an embedded input without a '\r' comes back as the same view, so the days that parsed it at compile time still recognise it
+		std::string input_contents = {};
+		std::string_view input = buffer::normalise_line_ends( embedded::input( i + 1 ), input_contents );
+		if ( input.empty() )
+		{
+			const std::string input_file = "./input/" + day_labels[i] + ".txt";
+			if ( !solvers::read_input_file( input_file, input_contents ) )
+			{
+				std::cout << "Unable to read " << input_file << std::endl;
+				return 1;
+			}
+			input = input_contents;
+		}
+		profiler::set_day( day_labels[i].c_str() );
+		results.push_back( questions[i]( input ) );
+		profiler::set_day( nullptr );
+		profiler::set_phase( nullptr );
+		if ( profile )
+		{
+			//empty the sample ring between days so long runs don't drop samples
+			profiler::drain();
+		}
+	}
+	profiler::stop();
+
+	//display results to console
+	print_results_table( results );
+	if ( profile )
+	{
+		if ( !profiler::write_folded( profile_directory ) )
+		{
+			std::cout << "Unable to write profile to " << profile_directory << std::endl;
+			return 1;
+		}
+		print_profile_report( results, day_labels, profile_directory );
+	}
 
-	
 	return 0;
 }
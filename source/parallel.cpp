@@ -0,0 +1,88 @@
+#include "parallel.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static uint32_t hardware_threads()
+{
+	return std::max( std::thread::hardware_concurrency(), 1u );
+}
+
+static std::atomic<uint32_t> s_thread_count = { hardware_threads() };
+
+void parallel::set_thread_count( const uint32_t threads )
+{
+	s_thread_count.store( (threads == 0) ? hardware_threads() : threads, std::memory_order_relaxed );
+}
+
+uint32_t parallel::thread_count()
+{
+	return s_thread_count.load( std::memory_order_relaxed );
+}
+
+size_t parallel::chunk_count( const size_t items, const size_t min_items_per_chunk )
+{
+	return std::clamp<size_t>( items / min_items_per_chunk, 1, 4 * static_cast<size_t>(thread_count()) );
+}
+
+void parallel::for_each_index( const size_t count, const std::function<void( size_t )>& body )
+{
+	const size_t threads = std::min<size_t>( thread_count(), count );
+	if ( threads <= 1 )
+	{
+		for ( size_t i = 0; i < count; ++i )
+		{
+			body( i );
+		}
+		return;
+	}
+
+	std::atomic<size_t> next_index = { 0 };
+	std::exception_ptr first_exception = nullptr;
+	std::mutex exception_mutex;
+	//workers carry on the profiler tags of the thread that started them so their samples land in the right day
+	const char* day = profiler::current_day();
+	const char* phase = profiler::current_phase();
+	const auto worker = [&]()
+	{
+		profiler::set_day( day );
+		profiler::set_phase( phase );
+		try
+		{
+			for ( size_t i = next_index.fetch_add( 1 ); i < count; i = next_index.fetch_add( 1 ) )
+			{
+				body( i );
+			}
+		}
+		catch ( ... )
+		{
+			//stop handing out work and keep the first failure for the caller
+			next_index.store( count );
+			const std::lock_guard<std::mutex> lock( exception_mutex );
+			if ( first_exception == nullptr )
+			{
+				first_exception = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> workers = {};
+	for ( size_t t = 1; t < threads; ++t )
+	{
+		workers.emplace_back( worker );
+	}
+	worker();
+	for ( auto& thread : workers )
+	{
+		thread.join();
+	}
+	if ( first_exception != nullptr )
+	{
+		std::rethrow_exception( first_exception );
+	}
+}
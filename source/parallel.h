@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/*
+ * Thread count shared by the parallel paths of the solvers. Parallel sections split their work
+ * into independent indices which are handed out to the worker threads as they become free, so
+ * uneven items (long spring rows, long light paths) don't leave threads idle.
+ */
+namespace parallel
+{
+	//number of threads parallel sections may use, 0 resets it to the hardware concurrency
+	extern void set_thread_count( uint32_t threads );
+	extern uint32_t thread_count();
+
+	//how many chunks to split items into for for_each_index. Each chunk holds at least min_items_per_chunk items so that a
+	//thread's share outweighs handing it out, small inputs stay in one chunk. There are at most four chunks per thread so
+	//that a thread which is descheduled doesn't hold up the rest
+	extern size_t chunk_count( size_t items, size_t min_items_per_chunk );
+
+	//call body( i ) for every i in [0, count), the calling thread takes part. The first exception thrown by body is rethrown here
+	extern void for_each_index( size_t count, const std::function<void( size_t )>& body );
+}
@@ -0,0 +1,320 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define AOC_PROFILER_SUPPORTED 1
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#else
+#define AOC_PROFILER_SUPPORTED 0
+#endif
+
+namespace profiler
+{
+	constexpr uint32_t max_stack_depth = 64;
+	constexpr uint64_t ring_capacity = 1 << 14;
+
+	struct Sample
+	{
+		std::atomic<uint64_t> sequence;		/** < set to index + 1 once the slot has been written */
+		const char* day;
+		const char* phase;
+		uint64_t handler_nanoseconds;
+		uint32_t depth;
+		void* frames[max_stack_depth];
+	};
+
+	//single consumer, any number of producers (signal handlers), slots are claimed with a compare exchange
+	//so a full ring drops the new sample rather than overwriting one that has not been read yet
+	static Sample s_ring[ring_capacity] = {};
+	static std::atomic<uint64_t> s_write_index = { 0 };
+	static std::atomic<uint64_t> s_read_index = { 0 };
+	static std::atomic<uint64_t> s_dropped = { 0 };
+
+	static thread_local const char* t_day = nullptr;
+	static thread_local const char* t_phase = nullptr;
+
+	struct Day_Samples
+	{
+		std::map<std::pair<std::string, std::vector<void*>>, uint64_t> stacks;	/** < phase and raw return addresses (root first) -> count */
+		uint64_t samples;
+		uint64_t handler_nanoseconds;
+	};
+
+	//aggregated samples, only touched by the consumer
+	static std::map<std::string, Day_Samples> s_days = {};
+}
+
+#if AOC_PROFILER_SUPPORTED
+namespace profiler
+{
+	static struct sigaction s_previous_action = {};
+	static bool s_running = false;
+
+	static uint64_t monotonic_nanoseconds()
+	{
+		timespec now = {};
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+	}
+
+	static void on_sigprof( int, siginfo_t*, void* )
+	{
+		const int saved_errno = errno;
+		const uint64_t begin = monotonic_nanoseconds();
+		//claim a slot, drop the sample if the consumer has fallen a full ring behind
+		uint64_t index = s_write_index.load( std::memory_order_relaxed );
+		do
+		{
+			if ( index - s_read_index.load( std::memory_order_acquire ) >= ring_capacity )
+			{
+				s_dropped.fetch_add( 1, std::memory_order_relaxed );
+				errno = saved_errno;
+				return;
+			}
+		} while ( !s_write_index.compare_exchange_weak( index, index + 1, std::memory_order_acq_rel ) );
+
+		Sample& sample = s_ring[index % ring_capacity];
+		sample.day = t_day;
+		sample.phase = t_phase;
+		sample.depth = static_cast<uint32_t>(backtrace( sample.frames, max_stack_depth ));
+		sample.handler_nanoseconds = monotonic_nanoseconds() - begin;
+		sample.sequence.store( index + 1, std::memory_order_release );
+		errno = saved_errno;
+	}
+
+	bool is_supported()
+	{
+		return true;
+	}
+
+	bool start( const uint32_t interval_microseconds )
+	{
+		if ( s_running || interval_microseconds == 0 )
+		{
+			return false;
+		}
+		//the first call to backtrace can allocate while it loads the unwinder, get that out of the way outside of the handler
+		void* warm_up[4];
+		backtrace( warm_up, 4 );
+
+		struct sigaction action = {};
+		action.sa_sigaction = on_sigprof;
+		action.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigemptyset( &action.sa_mask );
+		if ( sigaction( SIGPROF, &action, &s_previous_action ) != 0 )
+		{
+			return false;
+		}
+		itimerval timer = {};
+		timer.it_interval.tv_sec = interval_microseconds / 1000000;
+		timer.it_interval.tv_usec = interval_microseconds % 1000000;
+		timer.it_value = timer.it_interval;
+		if ( setitimer( ITIMER_PROF, &timer, nullptr ) != 0 )
+		{
+			sigaction( SIGPROF, &s_previous_action, nullptr );
+			return false;
+		}
+		s_running = true;
+		return true;
+	}
+
+	void stop()
+	{
+		if ( !s_running )
+		{
+			return;
+		}
+		itimerval timer = {};
+		setitimer( ITIMER_PROF, &timer, nullptr );
+		sigaction( SIGPROF, &s_previous_action, nullptr );
+		s_running = false;
+	}
+
+	//turn a return address into "function" or "module+0xoffset" if there is no symbol for it
+	static std::string symbol_name( void* address )
+	{
+		Dl_info info = {};
+		//return addresses point after the call, step back one byte so the call site's function is found
+		void* call_site = static_cast<char*>(address) - 1;
+		if ( dladdr( call_site, &info ) == 0 )
+		{
+			char buffer[32];
+			std::snprintf( buffer, sizeof( buffer ), "%p", address );
+			return buffer;
+		}
+		if ( info.dli_sname != nullptr )
+		{
+			int status = 0;
+			char* demangled = abi::__cxa_demangle( info.dli_sname, nullptr, nullptr, &status );
+			std::string name = (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+			std::free( demangled );
+			//drop the parameter list, flame graphs only need the function name
+			int32_t template_depth = 0;
+			for ( size_t i = 0; i < name.size(); ++i )
+			{
+				if ( name[i] == '<' ) { ++template_depth; }
+				else if ( name[i] == '>' ) { --template_depth; }
+				else if ( name[i] == '(' && template_depth == 0 && i > 0 && name.compare( 0, i, "operator" ) != 0 )
+				{
+					name.resize( i );
+					break;
+				}
+			}
+			//';' separates frames in the folded format
+			std::ranges::replace( name, ';', ':' );
+			return name;
+		}
+		std::string module = (info.dli_fname != nullptr) ? std::filesystem::path( info.dli_fname ).filename().string() : "?";
+		char buffer[32];
+		std::snprintf( buffer, sizeof( buffer ), "+0x%zx", static_cast<size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)) );
+		return module + buffer;
+	}
+}
+#else
+namespace profiler
+{
+	bool is_supported()
+	{
+		return false;
+	}
+
+	bool start( const uint32_t )
+	{
+		return false;
+	}
+
+	void stop()
+	{
+	}
+
+	static std::string symbol_name( void* address )
+	{
+		char buffer[32];
+		std::snprintf( buffer, sizeof( buffer ), "%p", address );
+		return buffer;
+	}
+}
+#endif
+
+void profiler::set_day( const char* day )
+{
+	t_day = day;
+}
+
+void profiler::set_phase( const char* phase )
+{
+	t_phase = phase;
+}
+
+const char* profiler::current_day()
+{
+	return t_day;
+}
+
+const char* profiler::current_phase()
+{
+	return t_phase;
+}
+
+void profiler::drain()
+{
+	//the top two frames are the signal handler and the kernel's signal return trampoline
+	constexpr uint32_t handler_frames = 2;
+
+	uint64_t index = s_read_index.load( std::memory_order_relaxed );
+	while ( index < s_write_index.load( std::memory_order_acquire ) )
+	{
+		Sample& sample = s_ring[index % ring_capacity];
+		if ( sample.sequence.load( std::memory_order_acquire ) != index + 1 )
+		{
+			//claimed but still being written, pick it up next time
+			break;
+		}
+		Day_Samples& day = s_days[(sample.day != nullptr) ? sample.day : "unattributed"];
+		//folded stacks are written root first
+		std::vector<void*> stack = {};
+		for ( uint32_t i = sample.depth; i > handler_frames; --i )
+		{
+			stack.push_back( sample.frames[i - 1] );
+		}
+		++day.stacks[{ (sample.phase != nullptr) ? sample.phase : "unknown", stack }];
+		++day.samples;
+		day.handler_nanoseconds += sample.handler_nanoseconds;
+		++index;
+		s_read_index.store( index, std::memory_order_release );
+	}
+}
+
+bool profiler::write_folded( const std::string& directory )
+{
+	drain();
+	std::error_code error = {};
+	std::filesystem::create_directories( directory, error );
+	if ( error )
+	{
+		return false;
+	}
+	std::map<void*, std::string> symbols = {};
+	for ( const auto& [day, samples] : s_days )
+	{
+		//different return addresses inside the same function fold into the same named stack
+		std::map<std::string, uint64_t> folded_stacks = {};
+		for ( const auto& [phase_stack, count] : samples.stacks )
+		{
+			//the day and phase are written as pseudo frames at the root of every stack
+			const auto& [phase, stack] = phase_stack;
+			std::string folded = day + ';' + phase;
+			for ( void* address : stack )
+			{
+				auto symbol = symbols.find( address );
+				if ( symbol == symbols.end() )
+				{
+					symbol = symbols.emplace( address, symbol_name( address ) ).first;
+				}
+				folded += ';' + symbol->second;
+			}
+			folded_stacks[folded] += count;
+		}
+
+		std::ofstream file_output( std::filesystem::path( directory ) / (day + ".folded") );
+		if ( !file_output.is_open() )
+		{
+			return false;
+		}
+		for ( const auto& [folded, count] : folded_stacks )
+		{
+			file_output << folded << ' ' << count << '\n';
+		}
+		file_output.close();
+	}
+	return true;
+}
+
+std::vector<profiler::Day_Report> profiler::get_reports()
+{
+	drain();
+	std::vector<Day_Report> reports = {};
+	for ( const auto& [day, samples] : s_days )
+	{
+		reports.push_back( { day, samples.samples, samples.handler_nanoseconds / 1000000000.0 } );
+	}
+	return reports;
+}
+
+uint64_t profiler::dropped_samples()
+{
+	return s_dropped.load( std::memory_order_relaxed );
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * A small built in sampling profiler. An interval timer (SIGPROF) interrupts the process, the
+ * handler unwinds the interrupted thread and pushes the stack into a lock free ring buffer.
+ * Samples are tagged with the day and phase set on the interrupted thread and are written out
+ * as collapsed/folded stacks (one file per day) that can be fed straight into flamegraph.pl.
+ * Only available on POSIX platforms, symbol names need the executable linked with -rdynamic.
+ */
+namespace profiler
+{
+	//is sampling supported on this platform
+	extern bool is_supported();
+
+	//install the SIGPROF handler and start the interval timer, returns false if it could not be started
+	extern bool start( uint32_t interval_microseconds );
+
+	//stop the interval timer and restore the previous handler
+	extern void stop();
+
+	//tag any samples taken on this thread with the day/phase, pointers must stay valid while profiling
+	extern void set_day( const char* day );
+	extern void set_phase( const char* phase );
+
+	extern const char* current_day();
+	extern const char* current_phase();
+
+	//move any samples from the ring buffer into the aggregated stack counts
+	extern void drain();
+
+	struct Day_Report
+	{
+		std::string day;
+		uint64_t samples;
+		double handler_seconds;		/** < time spent inside the signal handler for this day's samples */
+	};
+
+	//write <directory>/<day>.folded for every day that has samples, returns false if the files could not be written
+	extern bool write_folded( const std::string& directory );
+
+	//per day sample counts and sampling cost
+	extern std::vector<Day_Report> get_reports();
+
+	//samples lost because the ring buffer was full
+	extern uint64_t dropped_samples();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Result;
+
+/*
+ * Streaming engine for day 3 schematics of any height. A symbol only touches the rows above and
+ * below it, so rows are pushed one at a time into a ring of three and a row's symbols are summed
+ * as soon as the row after it arrives. Only the three rows and the part numbers found on them are
+ * held, the row buffers are reused so memory stays constant once the widest row has been seen.
+ */
+namespace schematic_window
+{
+	struct Totals
+	{
+		uint64_t part_number_sum;	/** < part 1 */
+		uint64_t gear_ratio_sum;	/** < part 2 */
+	};
+
+	struct Window_Row
+	{
+		std::string text;
+		std::vector<uint32_t> cell_part;	/** < column -> index into ids of the part number covering it */
+		std::vector<uint32_t> ids;
+	};
+
+	struct Window
+	{
+		std::array<Window_Row, 3> rows;		/** < row n is held in rows[n % 3] */
+		uint64_t row_count;					/** < rows pushed so far */
+		Totals totals;
+	};
+
+	//add the next row of the schematic, the symbols of the row before it are summed into the totals
+	extern void push_row( Window& window, std::string_view row );
+
+	//sum the symbols of the last row and return the totals of every row
+	extern Totals finish( Window& window );
+
+	//read a schematic a line at a time, the whole schematic is never held in memory
+	extern Totals solve( std::istream& input );
+
+	//solve a day 3 input held in memory through the window, registered as a variant of the day 3 solver
+	extern Result solve_input( std::string_view input );
+}
@@ -0,0 +1,790 @@
+//\==============================================================================
+// Instruction set specific variants of the hot kernels used by the day solutions.
+// Each instruction set gets its own namespace and a cpu::Kernels table at the bottom
+// of the file, cpu_dispatch.cpp picks which table is active at runtime.
+//\==============================================================================
+
+#include "simd_kernels.h"
+#include "uint128.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if AOC_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace simd
+{
+	//day 15 HASH is sum( c[i] * 17^(n-i) ) mod 256. 17^16 mod 256 == 1 so a block of 16, 32 or 64 characters
+	//can be hashed as a dot product against these weights and blocks simply add together.
+	//weights are stored as signed bytes for maddubs, values are the same mod 256
+	constexpr std::array<int8_t, 64> make_hash_weights()
+	{
+		std::array<int8_t, 64> weights = {};
+		for ( uint32_t i = 0; i < weights.size(); ++i )
+		{
+			uint32_t power = 1;
+			for ( uint32_t p = 0; p < 16 - (i % 16); ++p )
+			{
+				power = (power * 17) & 0xFF;
+			}
+			weights[i] = static_cast<int8_t>(power);
+		}
+		return weights;
+	}
+
+	alignas(64) constexpr std::array<int8_t, 64> hash_weights = make_hash_weights();
+
+	//day 1 calibration, the first and last digit of the line being scanned are carried from one block to the next
+	struct Calibration_State
+	{
+		uint64_t sum;
+		int32_t first;	/** < -1 until a digit has been seen on the line */
+		int32_t last;
+	};
+
+	inline void end_line( Calibration_State& state )
+	{
+		if ( state.first >= 0 )
+		{
+			state.sum += static_cast<uint64_t>(10 * state.first + state.last);
+		}
+		state.first = -1;
+	}
+
+	//fold a block of up to 64 characters into the state, bit n of the masks is set if block[n] is a digit / newline
+	inline void consume_block( const char* block, uint64_t digits, uint64_t newlines, Calibration_State& state )
+	{
+		for ( ;; )
+		{
+			//digits ahead of the next newline belong to the current line
+			const uint64_t line_digits = (newlines != 0) ? digits & ((newlines & (~newlines + 1)) - 1) : digits;
+			if ( line_digits != 0 )
+			{
+				if ( state.first < 0 )
+				{
+					state.first = block[std::countr_zero( line_digits )] - '0';
+				}
+				state.last = block[63 - std::countl_zero( line_digits )] - '0';
+			}
+			if ( newlines == 0 )
+			{
+				return;
+			}
+			end_line( state );
+			digits &= ~line_digits;
+			newlines &= newlines - 1;
+		}
+	}
+
+	namespace scalar
+	{
+		constexpr bool is_digit( const char c )
+		{
+			return static_cast<uint8_t>(c - '0') < 10;
+		}
+
+		size_t find_first_digit( const char* data, const size_t length )
+		{
+			for ( size_t i = 0; i < length; ++i )
+			{
+				if ( is_digit( data[i] ) ) { return i; }
+			}
+			return cpu::not_found;
+		}
+
+		size_t find_last_digit( const char* data, const size_t length )
+		{
+			for ( size_t i = length; i > 0; --i )
+			{
+				if ( is_digit( data[i - 1] ) ) { return i - 1; }
+			}
+			return cpu::not_found;
+		}
+
+		void count_card_matches( const uint64_t* winning, const uint64_t* have, const size_t card_count, uint8_t* matches )
+		{
+			for ( size_t i = 0; i < card_count; ++i )
+			{
+				matches[i] = static_cast<uint8_t>(std::popcount( winning[2 * i] & have[2 * i] ) + std::popcount( winning[2 * i + 1] & have[2 * i + 1] ));
+			}
+		}
+
+		//continue a hash from the value passed in, used by the vector variants for any trailing characters
+		uint8_t holiday_hash_from( uint32_t value, const char* data, const size_t length )
+		{
+			for ( size_t i = 0; i < length; ++i )
+			{
+				value = ((value + static_cast<uint8_t>(data[i])) * 17) & 0xFF;
+			}
+			return static_cast<uint8_t>(value);
+		}
+
+		uint8_t holiday_hash( const char* data, const size_t length )
+		{
+			return holiday_hash_from( 0, data, length );
+		}
+
+		bool rows_equal( const char* a, const char* b, const size_t length )
+		{
+			return std::memcmp( a, b, length ) == 0;
+		}
+
+		constexpr bool is_structural( const char c )
+		{
+			return c == ':' || c == '|' || c == '(' || c == '{' || c == '>';
+		}
+
+		void classify_structure( const char* data, const size_t length, uint64_t* newline_bits, uint64_t* structural_bits )
+		{
+			for ( size_t block = 0; block * 64 < length; ++block )
+			{
+				uint64_t newlines = {};
+				uint64_t structurals = {};
+				const size_t count = std::min<size_t>( length - block * 64, 64 );
+				for ( size_t i = 0; i < count; ++i )
+				{
+					const char c = data[block * 64 + i];
+					newlines |= static_cast<uint64_t>(c == '\n') << i;
+					structurals |= static_cast<uint64_t>(is_structural( c )) << i;
+				}
+				newline_bits[block] = newlines;
+				structural_bits[block] = structurals;
+			}
+		}
+
+		//continue a calibration sum, used by the vector variants for any trailing characters
+		void calibration_from( const char* data, const size_t length, Calibration_State& state )
+		{
+			for ( size_t i = 0; i < length; ++i )
+			{
+				if ( data[i] == '\n' )
+				{
+					end_line( state );
+				}
+				else if ( is_digit( data[i] ) )
+				{
+					if ( state.first < 0 )
+					{
+						state.first = data[i] - '0';
+					}
+					state.last = data[i] - '0';
+				}
+			}
+		}
+
+		uint64_t calibration_sum( const char* data, const size_t length )
+		{
+			Calibration_State state = { 0, -1, 0 };
+			calibration_from( data, length, state );
+			end_line( state );
+			return state.sum;
+		}
+
+		//branchless search, every value takes the same number of steps so the vector variants can run it on several values at once
+		uint64_t piecewise_value( const uint64_t* starts, const uint64_t* offsets, const size_t piece_count, const uint64_t value )
+		{
+			const uint64_t* base = starts;
+			for ( size_t n = piece_count; n > 1; )
+			{
+				const size_t half = n / 2;
+				base = (base[half] <= value) ? base + half : base;
+				n -= half;
+			}
+			return value + offsets[base - starts];
+		}
+
+		void piecewise_lookup( const uint64_t* starts, const uint64_t* offsets, const size_t piece_count, const uint64_t* values, const size_t value_count, uint64_t* results )
+		{
+			for ( size_t i = 0; i < value_count; ++i )
+			{
+				results[i] = piecewise_value( starts, offsets, piece_count, values[i] );
+			}
+		}
+
+		//h * (t - h) > d exactly for the h with (2h - t)^2 <= t^2 - 4(d + 1). 2h - t has the parity of t, so of the values
+		//in [-root, root] every other one is a win, root + 1 of them when root has the parity of t and root otherwise
+		uint64_t race_win_count( const uint64_t time, const uint64_t distance )
+		{
+			uint64_t root = {};
+			if ( time < (1 << 26) && distance < (1ULL << 61) )
+			{
+				//the square is below 2^52 so a double holds it exactly and its root truncates to the integer root or one above it
+				const uint64_t square = time * time;
+				const uint64_t limit = (distance << 2) + 4;
+				if ( square < limit )
+				{
+					return 0;
+				}
+				root = static_cast<uint64_t>(std::sqrt( static_cast<double>(square - limit) ));
+				root -= (root * root > square - limit) ? 1 : 0;
+			}
+			else
+			{
+				const wide::Uint128 square = wide::multiply( time, time );
+				const wide::Uint128 limit = wide::Uint128{ distance << 2, distance >> 62 } + wide::Uint128{ 4, 0 };
+				if ( square < limit )
+				{
+					return 0;
+				}
+				root = wide::isqrt( square - limit );
+			}
+			return root + 1 - ((root ^ time) & 1);
+		}
+
+		void race_wins( const uint64_t* times, const uint64_t* distances, const size_t count, uint64_t* wins )
+		{
+			for ( size_t i = 0; i < count; ++i )
+			{
+				wins[i] = race_win_count( times[i], distances[i] );
+			}
+		}
+	}
+
+#if AOC_X86_KERNELS
+	namespace sse42
+	{
+		//pcmpestri range compare, pairs of bytes describe inclusive ranges
+		AOC_TARGET_SSE42 size_t find_first_digit( const char* data, const size_t length )
+		{
+			const __m128i digit_range = _mm_setr_epi8( '0', '9', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 );
+			size_t i = 0;
+			for ( ; i + 16 <= length; i += 16 )
+			{
+				const __m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>(data + i) );
+				const int index = _mm_cmpestri( digit_range, 2, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT );
+				if ( index < 16 ) { return i + index; }
+			}
+			const size_t tail = scalar::find_first_digit( data + i, length - i );
+			return (tail == cpu::not_found) ? cpu::not_found : i + tail;
+		}
+
+		AOC_TARGET_SSE42 size_t find_last_digit( const char* data, const size_t length )
+		{
+			const __m128i digit_range = _mm_setr_epi8( '0', '9', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 );
+			size_t end = length;
+			for ( ; end >= 16; end -= 16 )
+			{
+				const __m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>(data + end - 16) );
+				const int index = _mm_cmpestri( digit_range, 2, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_MOST_SIGNIFICANT );
+				if ( index < 16 ) { return end - 16 + index; }
+			}
+			return scalar::find_last_digit( data, end );
+		}
+
+		//one AND covers a whole card, the two halves are counted with popcnt
+		AOC_TARGET_SSE42 void count_card_matches( const uint64_t* winning, const uint64_t* have, const size_t card_count, uint8_t* matches )
+		{
+			for ( size_t i = 0; i < card_count; ++i )
+			{
+				const __m128i both = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>(winning + 2 * i) ),
+													_mm_loadu_si128( reinterpret_cast<const __m128i*>(have + 2 * i) ) );
+				matches[i] = static_cast<uint8_t>(_mm_popcnt_u64( static_cast<uint64_t>(_mm_cvtsi128_si64( both )) ) +
+												  _mm_popcnt_u64( static_cast<uint64_t>(_mm_extract_epi64( both, 1 )) ));
+			}
+		}
+
+		AOC_TARGET_SSE42 uint8_t holiday_hash( const char* data, const size_t length )
+		{
+			const __m128i weights = _mm_load_si128( reinterpret_cast<const __m128i*>(hash_weights.data()) );
+			const __m128i ones = _mm_set1_epi16( 1 );
+			__m128i sums = _mm_setzero_si128();
+			size_t i = 0;
+			for ( ; i + 16 <= length; i += 16 )
+			{
+				const __m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>(data + i) );
+				sums = _mm_add_epi32( sums, _mm_madd_epi16( _mm_maddubs_epi16( chunk, weights ), ones ) );
+			}
+			sums = _mm_add_epi32( sums, _mm_shuffle_epi32( sums, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+			sums = _mm_add_epi32( sums, _mm_shuffle_epi32( sums, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+			const auto value = static_cast<uint32_t>(_mm_cvtsi128_si32( sums ));
+			return scalar::holiday_hash_from( value & 0xFF, data + i, length - i );
+		}
+
+		AOC_TARGET_SSE42 bool rows_equal( const char* a, const char* b, const size_t length )
+		{
+			size_t i = 0;
+			for ( ; i + 16 <= length; i += 16 )
+			{
+				const __m128i ra = _mm_loadu_si128( reinterpret_cast<const __m128i*>(a + i) );
+				const __m128i rb = _mm_loadu_si128( reinterpret_cast<const __m128i*>(b + i) );
+				if ( _mm_movemask_epi8( _mm_cmpeq_epi8( ra, rb ) ) != 0xFFFF ) { return false; }
+			}
+			return std::memcmp( a + i, b + i, length - i ) == 0;
+		}
+
+		//bit n of each mask is set if chunk[n] is a newline or a structural character
+		AOC_TARGET_SSE42 static void structure_masks( const __m128i chunk, uint32_t& newlines, uint32_t& structurals )
+		{
+			newlines = static_cast<uint32_t>(_mm_movemask_epi8( _mm_cmpeq_epi8( chunk, _mm_set1_epi8( '\n' ) ) ));
+			__m128i is_structural = _mm_cmpeq_epi8( chunk, _mm_set1_epi8( ':' ) );
+			is_structural = _mm_or_si128( is_structural, _mm_cmpeq_epi8( chunk, _mm_set1_epi8( '|' ) ) );
+			is_structural = _mm_or_si128( is_structural, _mm_cmpeq_epi8( chunk, _mm_set1_epi8( '(' ) ) );
+			is_structural = _mm_or_si128( is_structural, _mm_cmpeq_epi8( chunk, _mm_set1_epi8( '{' ) ) );
+			is_structural = _mm_or_si128( is_structural, _mm_cmpeq_epi8( chunk, _mm_set1_epi8( '>' ) ) );
+			structurals = static_cast<uint32_t>(_mm_movemask_epi8( is_structural ));
+		}
+
+		AOC_TARGET_SSE42 void classify_structure( const char* data, const size_t length, uint64_t* newline_bits, uint64_t* structural_bits )
+		{
+			size_t block = 0;
+			for ( ; block * 64 + 64 <= length; ++block )
+			{
+				uint64_t newlines = {};
+				uint64_t structurals = {};
+				for ( uint32_t lane = 0; lane < 4; ++lane )
+				{
+					uint32_t n = {};
+					uint32_t s = {};
+					structure_masks( _mm_loadu_si128( reinterpret_cast<const __m128i*>(data + block * 64 + lane * 16) ), n, s );
+					newlines |= static_cast<uint64_t>(n) << (lane * 16);
+					structurals |= static_cast<uint64_t>(s) << (lane * 16);
+				}
+				newline_bits[block] = newlines;
+				structural_bits[block] = structurals;
+			}
+			if ( block * 64 < length )
+			{
+				scalar::classify_structure( data + block * 64, length - block * 64, newline_bits + block, structural_bits + block );
+			}
+		}
+
+		AOC_TARGET_SSE42 uint64_t calibration_sum( const char* data, const size_t length )
+		{
+			Calibration_State state = { 0, -1, 0 };
+			const __m128i nine = _mm_set1_epi8( 9 );
+			size_t i = 0;
+			for ( ; i + 64 <= length; i += 64 )
+			{
+				uint64_t digits = {};
+				uint64_t newlines = {};
+				for ( uint32_t lane = 0; lane < 4; ++lane )
+				{
+					const __m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>(data + i + lane * 16) );
+					const __m128i offset = _mm_sub_epi8( chunk, _mm_set1_epi8( '0' ) );
+					const auto digit_mask = static_cast<uint32_t>(_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_min_epu8( offset, nine ), offset ) ));
+					const auto newline_mask = static_cast<uint32_t>(_mm_movemask_epi8( _mm_cmpeq_epi8( chunk, _mm_set1_epi8( '\n' ) ) ));
+					digits |= static_cast<uint64_t>(digit_mask) << (lane * 16);
+					newlines |= static_cast<uint64_t>(newline_mask) << (lane * 16);
+				}
+				consume_block( data + i, digits, newlines, state );
+			}
+			scalar::calibration_from( data + i, length - i, state );
+			end_line( state );
+			return state.sum;
+		}
+	}
+
+	namespace avx2
+	{
+		//bit n of the result is set if data[n] is a digit
+		AOC_TARGET_AVX2 static uint32_t digit_mask( const char* data )
+		{
+			const __m256i chunk = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(data) );
+			//unsigned (c - '0') <= 9 is a digit
+			const __m256i offset = _mm256_sub_epi8( chunk, _mm256_set1_epi8( '0' ) );
+			const __m256i is_digit = _mm256_cmpeq_epi8( _mm256_min_epu8( offset, _mm256_set1_epi8( 9 ) ), offset );
+			return static_cast<uint32_t>(_mm256_movemask_epi8( is_digit ));
+		}
+
+		AOC_TARGET_AVX2 size_t find_first_digit( const char* data, const size_t length )
+		{
+			size_t i = 0;
+			for ( ; i + 32 <= length; i += 32 )
+			{
+				if ( const uint32_t mask = digit_mask( data + i ); mask != 0 )
+				{
+					return i + std::countr_zero( mask );
+				}
+			}
+			const size_t tail = sse42::find_first_digit( data + i, length - i );
+			return (tail == cpu::not_found) ? cpu::not_found : i + tail;
+		}
+
+		AOC_TARGET_AVX2 size_t find_last_digit( const char* data, const size_t length )
+		{
+			size_t end = length;
+			for ( ; end >= 32; end -= 32 )
+			{
+				if ( const uint32_t mask = digit_mask( data + end - 32 ); mask != 0 )
+				{
+					return end - 1 - std::countl_zero( mask );
+				}
+			}
+			return sse42::find_last_digit( data, end );
+		}
+
+		//bits set in each 64 bit lane, nibble lookup then a horizontal byte sum
+		AOC_TARGET_AVX2 static __m256i popcount_lanes( const __m256i value )
+		{
+			const __m256i lookup = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+			const __m256i nibbles = _mm256_set1_epi8( 0x0F );
+			const __m256i low = _mm256_shuffle_epi8( lookup, _mm256_and_si256( value, nibbles ) );
+			const __m256i high = _mm256_shuffle_epi8( lookup, _mm256_and_si256( _mm256_srli_epi16( value, 4 ), nibbles ) );
+			return _mm256_sad_epu8( _mm256_add_epi8( low, high ), _mm256_setzero_si256() );
+		}
+
+		//four cards per iteration, each vector holds two cards and the lane counts are paired back into card order
+		AOC_TARGET_AVX2 void count_card_matches( const uint64_t* winning, const uint64_t* have, const size_t card_count, uint8_t* matches )
+		{
+			size_t i = 0;
+			for ( ; i + 4 <= card_count; i += 4 )
+			{
+				const __m256i first = popcount_lanes( _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(winning + 2 * i) ),
+																		_mm256_loadu_si256( reinterpret_cast<const __m256i*>(have + 2 * i) ) ) );
+				const __m256i second = popcount_lanes( _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(winning + 2 * i + 4) ),
+																		 _mm256_loadu_si256( reinterpret_cast<const __m256i*>(have + 2 * i + 4) ) ) );
+				//cards 0, 2, 1, 3 after the pairwise add, the permute puts them in order
+				const __m256i counts = _mm256_permute4x64_epi64( _mm256_add_epi64( _mm256_unpacklo_epi64( first, second ), _mm256_unpackhi_epi64( first, second ) ), 0xD8 );
+				alignas(32) uint64_t card_counts[4];
+				_mm256_store_si256( reinterpret_cast<__m256i*>(card_counts), counts );
+				for ( size_t c = 0; c < 4; ++c )
+				{
+					matches[i + c] = static_cast<uint8_t>(card_counts[c]);
+				}
+			}
+			scalar::count_card_matches( winning + 2 * i, have + 2 * i, card_count - i, matches + i );
+		}
+
+		AOC_TARGET_AVX2 uint8_t holiday_hash( const char* data, const size_t length )
+		{
+			const __m256i weights = _mm256_load_si256( reinterpret_cast<const __m256i*>(hash_weights.data()) );
+			const __m256i ones = _mm256_set1_epi16( 1 );
+			__m256i sums = _mm256_setzero_si256();
+			size_t i = 0;
+			for ( ; i + 32 <= length; i += 32 )
+			{
+				const __m256i chunk = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(data + i) );
+				sums = _mm256_add_epi32( sums, _mm256_madd_epi16( _mm256_maddubs_epi16( chunk, weights ), ones ) );
+			}
+			__m128i half = _mm_add_epi32( _mm256_castsi256_si128( sums ), _mm256_extracti128_si256( sums, 1 ) );
+			half = _mm_add_epi32( half, _mm_shuffle_epi32( half, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+			half = _mm_add_epi32( half, _mm_shuffle_epi32( half, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+			const auto value = static_cast<uint32_t>(_mm_cvtsi128_si32( half ));
+			return scalar::holiday_hash_from( value & 0xFF, data + i, length - i );
+		}
+
+		AOC_TARGET_AVX2 bool rows_equal( const char* a, const char* b, const size_t length )
+		{
+			size_t i = 0;
+			for ( ; i + 32 <= length; i += 32 )
+			{
+				const __m256i ra = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(a + i) );
+				const __m256i rb = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(b + i) );
+				if ( static_cast<uint32_t>(_mm256_movemask_epi8( _mm256_cmpeq_epi8( ra, rb ) )) != 0xFFFFFFFF ) { return false; }
+			}
+			return sse42::rows_equal( a + i, b + i, length - i );
+		}
+
+		AOC_TARGET_AVX2 static void structure_masks( const __m256i chunk, uint32_t& newlines, uint32_t& structurals )
+		{
+			newlines = static_cast<uint32_t>(_mm256_movemask_epi8( _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( '\n' ) ) ));
+			__m256i is_structural = _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( ':' ) );
+			is_structural = _mm256_or_si256( is_structural, _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( '|' ) ) );
+			is_structural = _mm256_or_si256( is_structural, _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( '(' ) ) );
+			is_structural = _mm256_or_si256( is_structural, _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( '{' ) ) );
+			is_structural = _mm256_or_si256( is_structural, _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( '>' ) ) );
+			structurals = static_cast<uint32_t>(_mm256_movemask_epi8( is_structural ));
+		}
+
+		AOC_TARGET_AVX2 void classify_structure( const char* data, const size_t length, uint64_t* newline_bits, uint64_t* structural_bits )
+		{
+			size_t block = 0;
+			for ( ; block * 64 + 64 <= length; ++block )
+			{
+				uint32_t low_newlines = {};
+				uint32_t low_structurals = {};
+				uint32_t high_newlines = {};
+				uint32_t high_structurals = {};
+				structure_masks( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(data + block * 64) ), low_newlines, low_structurals );
+				structure_masks( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(data + block * 64 + 32) ), high_newlines, high_structurals );
+				newline_bits[block] = (static_cast<uint64_t>(high_newlines) << 32) | low_newlines;
+				structural_bits[block] = (static_cast<uint64_t>(high_structurals) << 32) | low_structurals;
+			}
+			if ( block * 64 < length )
+			{
+				sse42::classify_structure( data + block * 64, length - block * 64, newline_bits + block, structural_bits + block );
+			}
+		}
+
+		AOC_TARGET_AVX2 static uint32_t newline_mask( const char* data )
+		{
+			const __m256i chunk = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(data) );
+			return static_cast<uint32_t>(_mm256_movemask_epi8( _mm256_cmpeq_epi8( chunk, _mm256_set1_epi8( '\n' ) ) ));
+		}
+
+		AOC_TARGET_AVX2 uint64_t calibration_sum( const char* data, const size_t length )
+		{
+			Calibration_State state = { 0, -1, 0 };
+			size_t i = 0;
+			for ( ; i + 64 <= length; i += 64 )
+			{
+				const uint64_t digits = (static_cast<uint64_t>(digit_mask( data + i + 32 )) << 32) | digit_mask( data + i );
+				const uint64_t newlines = (static_cast<uint64_t>(newline_mask( data + i + 32 )) << 32) | newline_mask( data + i );
+				consume_block( data + i, digits, newlines, state );
+			}
+			scalar::calibration_from( data + i, length - i, state );
+			end_line( state );
+			return state.sum;
+		}
+
+		//races with times below 2^26 have a square below 2^52, a double holds it exactly and the root of it is correctly rounded,
+		//so the rounded root is the integer root or one above it. Distances are held below 2^60 so that 4(d + 1) stays below 2^63
+		//for the signed compare. Races outside that take the scalar integer root
+		AOC_TARGET_AVX2 void race_wins( const uint64_t* times, const uint64_t* distances, const size_t count, uint64_t* wins )
+		{
+			//an integer below 2^52 or-ed into the mantissa of 2^52 is 2^52 + the integer as a double, which converts both ways without 64 bit conversions
+			const __m256i magic = _mm256_set1_epi64x( 0x4330000000000000 );
+			const __m256d magic_double = _mm256_set1_pd( 4503599627370496.0 );
+			size_t i = 0;
+			for ( ; i + 4 <= count; i += 4 )
+			{
+				const __m256i time = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(times + i) );
+				const __m256i distance = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(distances + i) );
+				const __m256i small = _mm256_and_si256( _mm256_cmpeq_epi64( _mm256_srli_epi64( time, 26 ), _mm256_setzero_si256() ),
+														_mm256_cmpeq_epi64( _mm256_srli_epi64( distance, 60 ), _mm256_setzero_si256() ) );
+				const __m256i square = _mm256_mul_epu32( time, time );
+				const __m256i limit = _mm256_add_epi64( _mm256_slli_epi64( distance, 2 ), _mm256_set1_epi64x( 4 ) );
+				const __m256i losing = _mm256_cmpgt_epi64( limit, square );
+				const __m256i discriminant = _mm256_andnot_si256( losing, _mm256_sub_epi64( square, limit ) );
+				const __m256d root_double = _mm256_sqrt_pd( _mm256_sub_pd( _mm256_castsi256_pd( _mm256_or_si256( discriminant, magic ) ), magic_double ) );
+				__m256i root = _mm256_xor_si256( _mm256_castpd_si256( _mm256_add_pd( root_double, magic_double ) ), magic );
+				root = _mm256_add_epi64( root, _mm256_cmpgt_epi64( _mm256_mul_epu32( root, root ), discriminant ) );
+				const __m256i parity = _mm256_and_si256( _mm256_xor_si256( root, time ), _mm256_set1_epi64x( 1 ) );
+				const __m256i win_count = _mm256_sub_epi64( _mm256_add_epi64( root, _mm256_set1_epi64x( 1 ) ), parity );
+				_mm256_storeu_si256( reinterpret_cast<__m256i*>(wins + i), _mm256_andnot_si256( losing, win_count ) );
+				for ( uint32_t large = ~_mm256_movemask_pd( _mm256_castsi256_pd( small ) ) & 0xF; large != 0; large &= large - 1 )
+				{
+					const size_t lane = i + std::countr_zero( large );
+					wins[lane] = scalar::race_win_count( times[lane], distances[lane] );
+				}
+			}
+			scalar::race_wins( times + i, distances + i, count - i, wins + i );
+		}
+	}
+
+	namespace avx512
+	{
+		//mask with the lowest count bits set, masked loads never touch the lanes that are off
+		AOC_TARGET_AVX512 static uint64_t lane_mask( const size_t count )
+		{
+			return (count >= 64) ? ~0ULL : ((1ULL << count) - 1);
+		}
+
+		AOC_TARGET_AVX512 static uint64_t digit_mask( const char* data, const size_t count )
+		{
+			const uint64_t lanes = lane_mask( count );
+			const __m512i chunk = _mm512_maskz_loadu_epi8( lanes, data );
+			const __m512i offset = _mm512_sub_epi8( chunk, _mm512_set1_epi8( '0' ) );
+			return _mm512_mask_cmplt_epu8_mask( lanes, offset, _mm512_set1_epi8( 10 ) );
+		}
+
+		AOC_TARGET_AVX512 size_t find_first_digit( const char* data, const size_t length )
+		{
+			for ( size_t i = 0; i < length; i += 64 )
+			{
+				if ( const uint64_t mask = digit_mask( data + i, length - i ); mask != 0 )
+				{
+					return i + std::countr_zero( mask );
+				}
+			}
+			return cpu::not_found;
+		}
+
+		AOC_TARGET_AVX512 size_t find_last_digit( const char* data, const size_t length )
+		{
+			for ( size_t end = length; end > 0; )
+			{
+				const size_t start = (end >= 64) ? end - 64 : 0;
+				if ( const uint64_t mask = digit_mask( data + start, end - start ); mask != 0 )
+				{
+					return start + 63 - std::countl_zero( mask );
+				}
+				end = start;
+			}
+			return cpu::not_found;
+		}
+
+		//eight cards per iteration, the same nibble lookup as avx2 with the counts narrowed straight to bytes
+		AOC_TARGET_AVX512 static __m512i popcount_lanes( const __m512i value )
+		{
+			const __m512i lookup = _mm512_broadcast_i32x4( _mm_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 ) );
+			const __m512i nibbles = _mm512_set1_epi8( 0x0F );
+			const __m512i low = _mm512_shuffle_epi8( lookup, _mm512_and_si512( value, nibbles ) );
+			const __m512i high = _mm512_shuffle_epi8( lookup, _mm512_and_si512( _mm512_srli_epi16( value, 4 ), nibbles ) );
+			return _mm512_sad_epu8( _mm512_add_epi8( low, high ), _mm512_setzero_si512() );
+		}
+
+		AOC_TARGET_AVX512 void count_card_matches( const uint64_t* winning, const uint64_t* have, const size_t card_count, uint8_t* matches )
+		{
+			//cards 0, 4, 1, 5, 2, 6, 3, 7 after the pairwise add
+			const __m512i card_order = _mm512_setr_epi64( 0, 2, 4, 6, 1, 3, 5, 7 );
+			size_t i = 0;
+			for ( ; i + 8 <= card_count; i += 8 )
+			{
+				const __m512i first = popcount_lanes( _mm512_and_si512( _mm512_loadu_si512( winning + 2 * i ), _mm512_loadu_si512( have + 2 * i ) ) );
+				const __m512i second = popcount_lanes( _mm512_and_si512( _mm512_loadu_si512( winning + 2 * i + 8 ), _mm512_loadu_si512( have + 2 * i + 8 ) ) );
+				const __m512i counts = _mm512_add_epi64( _mm512_unpacklo_epi64( first, second ), _mm512_unpackhi_epi64( first, second ) );
+				_mm_storel_epi64( reinterpret_cast<__m128i*>(matches + i), _mm512_cvtepi64_epi8( _mm512_permutexvar_epi64( card_order, counts ) ) );
+			}
+			scalar::count_card_matches( winning + 2 * i, have + 2 * i, card_count - i, matches + i );
+		}
+
+		AOC_TARGET_AVX512 uint8_t holiday_hash( const char* data, const size_t length )
+		{
+			const __m512i weights = _mm512_load_si512( hash_weights.data() );
+			const __m512i ones = _mm512_set1_epi16( 1 );
+			__m512i sums = _mm512_setzero_si512();
+			size_t i = 0;
+			for ( ; i + 64 <= length; i += 64 )
+			{
+				const __m512i chunk = _mm512_loadu_si512( data + i );
+				sums = _mm512_add_epi32( sums, _mm512_madd_epi16( _mm512_maddubs_epi16( chunk, weights ), ones ) );
+			}
+			alignas(64) uint32_t lanes[16] = {};
+			_mm512_store_si512( lanes, sums );
+			uint32_t value = {};
+			for ( const uint32_t lane : lanes )
+			{
+				value += lane;
+			}
+			return scalar::holiday_hash_from( value & 0xFF, data + i, length - i );
+		}
+
+		AOC_TARGET_AVX512 bool rows_equal( const char* a, const char* b, const size_t length )
+		{
+			for ( size_t i = 0; i < length; i += 64 )
+			{
+				const uint64_t lanes = lane_mask( length - i );
+				const __m512i ra = _mm512_maskz_loadu_epi8( lanes, a + i );
+				const __m512i rb = _mm512_maskz_loadu_epi8( lanes, b + i );
+				if ( _mm512_cmpneq_epi8_mask( ra, rb ) != 0 ) { return false; }
+			}
+			return true;
+		}
+
+		AOC_TARGET_AVX512 void classify_structure( const char* data, const size_t length, uint64_t* newline_bits, uint64_t* structural_bits )
+		{
+			for ( size_t block = 0; block * 64 < length; ++block )
+			{
+				//lanes past the end load as zero which matches nothing
+				const __m512i chunk = _mm512_maskz_loadu_epi8( lane_mask( length - block * 64 ), data + block * 64 );
+				newline_bits[block] = _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( '\n' ) );
+				structural_bits[block] = _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( ':' ) )
+					| _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( '|' ) )
+					| _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( '(' ) )
+					| _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( '{' ) )
+					| _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( '>' ) );
+			}
+		}
+
+		AOC_TARGET_AVX512 uint64_t calibration_sum( const char* data, const size_t length )
+		{
+			Calibration_State state = { 0, -1, 0 };
+			for ( size_t i = 0; i < length; i += 64 )
+			{
+				//lanes past the end load as zero which is neither a digit nor a newline
+				const uint64_t lanes = lane_mask( length - i );
+				const __m512i chunk = _mm512_maskz_loadu_epi8( lanes, data + i );
+				const uint64_t digits = _mm512_mask_cmplt_epu8_mask( lanes, _mm512_sub_epi8( chunk, _mm512_set1_epi8( '0' ) ), _mm512_set1_epi8( 10 ) );
+				const uint64_t newlines = _mm512_cmpeq_epi8_mask( chunk, _mm512_set1_epi8( '\n' ) );
+				consume_block( data + i, digits, newlines, state );
+			}
+			end_line( state );
+			return state.sum;
+		}
+
+		//the scalar search on eight values per vector, each step gathers the probed breakpoint of every lane. A single vector
+		//waits on its gather every step so four independent ones are run together, then the tail one masked vector at a time
+		AOC_TARGET_AVX512 void piecewise_lookup( const uint64_t* starts, const uint64_t* offsets, const size_t piece_count, const uint64_t* values, const size_t value_count, uint64_t* results )
+		{
+			constexpr size_t vectors = 4;
+			size_t i = 0;
+			for ( ; i + 8 * vectors <= value_count; i += 8 * vectors )
+			{
+				__m512i value[vectors];
+				__m512i base[vectors];
+				for ( size_t v = 0; v < vectors; ++v )
+				{
+					value[v] = _mm512_loadu_si512( values + i + 8 * v );
+					base[v] = _mm512_setzero_si512();
+				}
+				for ( size_t n = piece_count; n > 1; )
+				{
+					const size_t half = n / 2;
+					for ( size_t v = 0; v < vectors; ++v )
+					{
+						const __m512i probe = _mm512_add_epi64( base[v], _mm512_set1_epi64( static_cast<long long>(half) ) );
+						const __m512i start = _mm512_i64gather_epi64( probe, starts, 8 );
+						base[v] = _mm512_mask_blend_epi64( _mm512_cmple_epu64_mask( start, value[v] ), base[v], probe );
+					}
+					n -= half;
+				}
+				for ( size_t v = 0; v < vectors; ++v )
+				{
+					_mm512_storeu_si512( results + i + 8 * v, _mm512_add_epi64( value[v], _mm512_i64gather_epi64( base[v], offsets, 8 ) ) );
+				}
+			}
+			for ( ; i < value_count; i += 8 )
+			{
+				const auto lanes = static_cast<__mmask8>(lane_mask( value_count - i ));
+				const __m512i value = _mm512_maskz_loadu_epi64( lanes, values + i );
+				__m512i base = _mm512_setzero_si512();
+				for ( size_t n = piece_count; n > 1; )
+				{
+					const size_t half = n / 2;
+					const __m512i probe = _mm512_add_epi64( base, _mm512_set1_epi64( static_cast<long long>(half) ) );
+					const __m512i start = _mm512_mask_i64gather_epi64( _mm512_setzero_si512(), lanes, probe, starts, 8 );
+					base = _mm512_mask_blend_epi64( _mm512_cmple_epu64_mask( start, value ), base, probe );
+					n -= half;
+				}
+				const __m512i offset = _mm512_mask_i64gather_epi64( _mm512_setzero_si512(), lanes, base, offsets, 8 );
+				_mm512_mask_storeu_epi64( results + i, lanes, _mm512_add_epi64( value, offset ) );
+			}
+		}
+
+		//the avx2 kernel on eight races a vector, masked for the tail
+		AOC_TARGET_AVX512 void race_wins( const uint64_t* times, const uint64_t* distances, const size_t count, uint64_t* wins )
+		{
+			const __m512i magic = _mm512_set1_epi64( 0x4330000000000000 );
+			const __m512d magic_double = _mm512_set1_pd( 4503599627370496.0 );
+			const __m512i one = _mm512_set1_epi64( 1 );
+			for ( size_t i = 0; i < count; i += 8 )
+			{
+				const auto lanes = static_cast<__mmask8>(lane_mask( count - i ));
+				const __m512i time = _mm512_maskz_loadu_epi64( lanes, times + i );
+				const __m512i distance = _mm512_maskz_loadu_epi64( lanes, distances + i );
+				const __mmask8 small = _mm512_cmplt_epu64_mask( time, _mm512_set1_epi64( 1LL << 26 ) ) & _mm512_cmplt_epu64_mask( distance, _mm512_set1_epi64( 1LL << 61 ) );
+				const __m512i square = _mm512_mul_epu32( time, time );
+				const __m512i limit = _mm512_add_epi64( _mm512_slli_epi64( distance, 2 ), _mm512_set1_epi64( 4 ) );
+				const __mmask8 winning = _mm512_cmpge_epu64_mask( square, limit );
+				const __m512i discriminant = _mm512_maskz_sub_epi64( winning, square, limit );
+				const __m512d root_double = _mm512_sqrt_pd( _mm512_sub_pd( _mm512_castsi512_pd( _mm512_or_si512( discriminant, magic ) ), magic_double ) );
+				__m512i root = _mm512_xor_si512( _mm512_castpd_si512( _mm512_add_pd( root_double, magic_double ) ), magic );
+				root = _mm512_mask_sub_epi64( root, _mm512_cmpgt_epu64_mask( _mm512_mul_epu32( root, root ), discriminant ), root, one );
+				const __m512i parity = _mm512_and_si512( _mm512_xor_si512( root, time ), one );
+				const __m512i win_count = _mm512_maskz_sub_epi64( winning, _mm512_add_epi64( root, one ), parity );
+				_mm512_mask_storeu_epi64( wins + i, lanes, win_count );
+				for ( uint32_t large = lanes & ~small & 0xFF; large != 0; large &= large - 1 )
+				{
+					const size_t lane = i + std::countr_zero( large );
+					wins[lane] = scalar::race_win_count( times[lane], distances[lane] );
+				}
+			}
+		}
+	}
+#endif
+
+	const cpu::Kernels scalar_kernels = { scalar::find_first_digit, scalar::find_last_digit, scalar::count_card_matches, scalar::holiday_hash, scalar::rows_equal, scalar::classify_structure, scalar::calibration_sum, scalar::piecewise_lookup, scalar::race_wins };
+#if AOC_X86_KERNELS
+	//no gather before avx2, and avx2 gathers measured no faster than the branchless scalar search, so both tables keep it.
+	//sse4.2 also keeps the scalar race kernel, two races a vector don't pay for the lanes that fall back to the integer root
+	const cpu::Kernels sse42_kernels = { sse42::find_first_digit, sse42::find_last_digit, sse42::count_card_matches, sse42::holiday_hash, sse42::rows_equal, sse42::classify_structure, sse42::calibration_sum, scalar::piecewise_lookup, scalar::race_wins };
+	const cpu::Kernels avx2_kernels = { avx2::find_first_digit, avx2::find_last_digit, avx2::count_card_matches, avx2::holiday_hash, avx2::rows_equal, avx2::classify_structure, avx2::calibration_sum, scalar::piecewise_lookup, avx2::race_wins };
+	const cpu::Kernels avx512_kernels = { avx512::find_first_digit, avx512::find_last_digit, avx512::count_card_matches, avx512::holiday_hash, avx512::rows_equal, avx512::classify_structure, avx512::calibration_sum, avx512::piecewise_lookup, avx512::race_wins };
+#endif
+}
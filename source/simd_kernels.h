@@ -0,0 +1,30 @@
+#pragma once
+#include "cpu_dispatch.h"
+
+//x86 targets get vector variants of the kernels, everything else only gets the scalar table
+#if defined(_M_X64) || defined(__x86_64__)
+#define AOC_X86_KERNELS 1
+#else
+#define AOC_X86_KERNELS 0
+#endif
+
+//MSVC allows intrinsics for any instruction set in any function, gcc/clang need the target named per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define AOC_TARGET_SSE42
+#define AOC_TARGET_AVX2
+#define AOC_TARGET_AVX512
+#else
+#define AOC_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define AOC_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#define AOC_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx2,bmi,bmi2,popcnt")))
+#endif
+
+namespace simd
+{
+	extern const cpu::Kernels scalar_kernels;
+#if AOC_X86_KERNELS
+	extern const cpu::Kernels sse42_kernels;
+	extern const cpu::Kernels avx2_kernels;
+	extern const cpu::Kernels avx512_kernels;
+#endif
+}
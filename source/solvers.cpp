@@ -0,0 +1,353 @@
+#include "almanac.h"
+#include "buffer.h"
+#include "cpu_dispatch.h"
+#include "days.h"
+#include "embedded.h"
+#include "parallel.h"
+#include "result.h"
+#include "schematic_window.h"
+#include "solvers.h"
+#include "uint128.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+//samples that only hold one part of a puzzle (day_01_2, day_08_2) or need the structure of a real input (day_20) are left out
+static const std::vector<solvers::Day> s_registry = {
+	{ "day_01", aoc::day_01, references::day_01, { { "block_kernels", aoc::day_01 } }, { "day_01.txt" }, generators::day_01 },
+	{ "day_02", aoc::day_02, references::day_02, { { "colour_max_arrays", aoc::day_02 } }, { "day_02.txt" }, generators::day_02 },
+	{ "day_03", aoc::day_03, references::day_03, { { "cell_part_index", aoc::day_03 }, { "three_row_window", schematic_window::solve_input } }, { "day_03.txt" }, generators::day_03 },
+	{ "day_04", aoc::day_04, references::day_04, { { "card_masks", aoc::day_04 } }, { "day_04.txt" }, generators::day_04 },
+	{ "day_05", aoc::day_05, references::day_05, { { "composed_map", aoc::day_05 }, { "stage_ranges", almanac::solve_stage_ranges }, { "incremental_engine", almanac::solve_engine } }, { "day_05.txt" }, generators::day_05 },
+	{ "day_06", aoc::day_06, references::day_06, { { "integer_root", aoc::day_06 } }, { "day_06.txt" }, generators::day_06, true },
+	{ "day_07", aoc::day_07, aoc::day_07, {}, { "day_07.txt" }, generators::day_07 },
+	{ "day_08", aoc::day_08, aoc::day_08, {}, { "day_08.txt" }, nullptr },
+	{ "day_09", aoc::day_09, aoc::day_09, {}, { "day_09.txt" }, generators::day_09 },
+	{ "day_10", aoc::day_10, aoc::day_10, {}, { "day_10.txt", "day_10_2.txt" }, nullptr },
+	{ "day_11", aoc::day_11, aoc::day_11, {}, { "day_11.txt" }, generators::day_11 },
+	{ "day_12", aoc::day_12, aoc::day_12, {}, { "day_12.txt" }, generators::day_12 },
+	{ "day_13", aoc::day_13, aoc::day_13, {}, { "day_13.txt" }, nullptr },
+	{ "day_14", aoc::day_14, aoc::day_14, {}, { "day_14.txt" }, generators::day_14 },
+	{ "day_15", aoc::day_15, aoc::day_15, {}, { "day_15.txt" }, generators::day_15, true },
+	{ "day_16", aoc::day_16, aoc::day_16, {}, { "day_16.txt" }, generators::day_16 },
+	{ "day_17", aoc::day_17, aoc::day_17, {}, { "day_17.txt", "day_17_2.txt" }, generators::day_17 },
+	{ "day_18", aoc::day_18, aoc::day_18, {}, { "day_18.txt" }, generators::day_18, true },
+	{ "day_19", aoc::day_19, aoc::day_19, {}, { "day_19.txt" }, generators::day_19 },
+	{ "day_20", aoc::day_20, aoc::day_20, {}, {}, nullptr },
+};
+
+const std::vector<solvers::Day>& solvers::registry()
+{
+	return s_registry;
+}
+
+bool solvers::read_input_file( const std::string& input_file, std::string& contents )
+{
+	std::ifstream file_input( input_file, std::ios::binary );
+	if ( !file_input.is_open() )
+	{
+		return false;
+	}
+	std::stringstream ss;
+	ss << file_input.rdbuf();
+	contents = ss.str();
+	buffer::normalise_line_ends( contents );
+	return true;
+}
+
+//text with every line ended by "\r\n", the last one included so that single line inputs get a '\r' too
+static std::string with_crlf( const std::string_view text )
+{
+	std::string crlf = {};
+	crlf.reserve( text.size() + static_cast<size_t>(std::count( text.begin(), text.end(), '\n' )) + 2 );
+	for ( const char c : text )
+	{
+		crlf += (c == '\n') ? "\r\n" : std::string_view( &c, 1 );
+	}
+	if ( !text.empty() && text.back() != '\n' )
+	{
+		crlf += "\r\n";
+	}
+	return crlf;
+}
+
+//races on the edges of the race_wins fast paths, every supported instruction set has to agree with the scalar kernel on them.
+//returns false and prints the races where one didn't
+static bool check_race_kernels()
+{
+	const uint64_t edge_times[] = { 0, 1, 2, 100, (1ULL << 26) - 1, 1ULL << 26, UINT32_MAX, UINT64_MAX };
+	std::vector<uint64_t> times = {};
+	std::vector<uint64_t> distances = {};
+	for ( const uint64_t time : edge_times )
+	{
+		//around the limits the vector kernels put on the distance and around the largest distance the race can still beat
+		const wide::Uint128 best = wide::multiply( time / 2, time - time / 2 );
+		const uint64_t best_distance = (best.high != 0) ? UINT64_MAX : best.low;
+		const uint64_t edge_distances[] = { 0, 1, (1ULL << 60) - 1, 1ULL << 60, (1ULL << 61) - 1, 1ULL << 61, (1ULL << 62) - 1, UINT64_MAX,
+											best_distance - std::min<uint64_t>( best_distance, 1 ), best_distance };
+		for ( const uint64_t distance : edge_distances )
+		{
+			times.push_back( time );
+			distances.push_back( distance );
+		}
+	}
+
+	const cpu::Isa previous_isa = cpu::active_isa();
+	std::vector<uint64_t> expected( times.size() );
+	cpu::select( cpu::Isa::scalar );
+	cpu::kernels().race_wins( times.data(), distances.data(), times.size(), expected.data() );
+	bool all_match = true;
+	for ( const cpu::Isa isa : { cpu::Isa::sse42, cpu::Isa::avx2, cpu::Isa::avx512 } )
+	{
+		if ( !cpu::select( isa ) )
+		{
+			continue;
+		}
+		std::vector<uint64_t> wins( times.size() );
+		cpu::kernels().race_wins( times.data(), distances.data(), times.size(), wins.data() );
+		for ( size_t i = 0; i < times.size(); ++i )
+		{
+			if ( wins[i] != expected[i] )
+			{
+				std::cout << "  race_wins differs on " << cpu::isa_name( isa ) << " for time " << times[i] << " distance " << distances[i]
+					<< ": expected " << expected[i] << " got " << wins[i] << std::endl;
+				all_match = false;
+			}
+		}
+	}
+	cpu::select( previous_isa );
+	std::cout << std::left << std::setw( 8 ) << "kernels" << std::setw( 24 ) << "race_wins" << std::right << std::setw( 3 ) << times.size() << " races "
+		<< ((all_match) ? "ok" : "MISMATCH") << std::endl;
+	return all_match;
+}
+
+bool solvers::check( const Check_Options& options )
+{
+	std::error_code error = {};
+	std::filesystem::create_directories( options.scratch_directory, error );
+	if ( error )
+	{
+		std::cout << "Unable to create " << options.scratch_directory << std::endl;
+		return false;
+	}
+
+	bool all_match = true;
+	for ( const auto& day : s_registry )
+	{
+		if ( !options.day.empty() && options.day != day.label )
+		{
+			continue;
+		}
+		//gather the sample inputs that are present along with freshly generated ones, inputs are named by their path
+		std::vector<std::string> inputs = {};
+		std::vector<std::string> input_names = {};
+		//each sample is also written out with "\r\n" line ends and read back, it has to give the same answers as the sample
+		std::vector<std::pair<size_t, size_t>> crlf_copies = {};
+		for ( const auto& sample : day.samples )
+		{
+			const std::filesystem::path path = std::filesystem::path( options.sample_directory ) / sample;
+			std::string contents = {};
+			if ( read_input_file( path.string(), contents ) )
+			{
+				inputs.push_back( contents );
+				input_names.push_back( path.string() );
+				const size_t sample_index = inputs.size() - 1;
+				const std::string crlf = with_crlf( contents );
+				const std::filesystem::path crlf_path = std::filesystem::path( options.scratch_directory ) / (path.stem().string() + "_crlf.txt");
+				std::ofstream file_output( crlf_path, std::ios::binary );
+				file_output << crlf;
+				file_output.close();
+				if ( read_input_file( crlf_path.string(), contents ) )
+				{
+					crlf_copies.emplace_back( sample_index, inputs.size() );
+					inputs.push_back( contents );
+					input_names.push_back( crlf_path.string() );
+				}
+				//the compile time parsers see the embedded input as it was written, so they are handed the copy as it is too
+				if ( day.embedded_parse )
+				{
+					crlf_copies.emplace_back( sample_index, inputs.size() );
+					inputs.push_back( crlf );
+					input_names.push_back( crlf_path.string() + " (not normalised)" );
+				}
+			}
+		}
+		for ( uint32_t seed = 1; day.generate != nullptr && seed <= options.seeds; ++seed )
+		{
+			const std::filesystem::path path = std::filesystem::path( options.scratch_directory ) / (day.label + "_seed_" + std::to_string( seed ) + ".txt");
+			inputs.push_back( day.generate( seed ) );
+			input_names.push_back( path.string() );
+			std::ofstream file_output( path, std::ios::binary );
+			file_output << inputs.back();
+			file_output.close();
+		}
+		if ( inputs.empty() )
+		{
+			std::cout << std::left << std::setw( 8 ) << day.label << "no inputs to check" << std::right << std::endl;
+			continue;
+		}
+
+		//answers from the reference are what every variant is checked against
+		std::vector<std::pair<uint64_t, uint64_t>> expected = {};
+		double reference_seconds = {};
+		for ( const auto& input : inputs )
+		{
+			const Result result = day.reference( input );
+			expected.emplace_back( result.part_1, result.part_2 );
+			reference_seconds += result.execution_time;
+		}
+		std::cout << std::left << std::setw( 8 ) << day.label << std::setw( 24 ) << "reference" << std::right
+			<< std::setw( 3 ) << inputs.size() << " inputs " << std::setw( 12 ) << reference_seconds << "s" << std::endl;
+		for ( const auto& [sample, copy] : crlf_copies )
+		{
+			if ( expected[copy] != expected[sample] )
+			{
+				std::cout << "  reference differs on " << input_names[copy] << ": expected " << expected[sample].first << ", " << expected[sample].second
+					<< " got " << expected[copy].first << ", " << expected[copy].second << std::endl;
+				all_match = false;
+			}
+		}
+		//the entry point of a day that parsed its embedded input at compile time has to agree with parsing a copy of it at
+		//run time, as it is and with "\r\n" line ends
+		const std::string_view embedded_input = embedded::input( std::stoul( day.label.substr( 4 ) ) );
+		if ( day.embedded_parse && !embedded_input.empty() )
+		{
+			std::string runtime_copy( embedded_input );
+			buffer::normalise_line_ends( runtime_copy );
+			const Result copy_result = day.solve( runtime_copy );
+			const std::pair<std::string, Result> embedded_results[] = { { "the embedded input", day.solve( embedded_input ) },
+																	   { "the embedded input with \"\\r\\n\" line ends", day.solve( with_crlf( runtime_copy ) ) } };
+			for ( const auto& [name, result] : embedded_results )
+			{
+				if ( result.part_1 != copy_result.part_1 || result.part_2 != copy_result.part_2 )
+				{
+					std::cout << "  " << day.label << " differs on " << name << ": expected " << copy_result.part_1 << ", " << copy_result.part_2
+						<< " got " << result.part_1 << ", " << result.part_2 << std::endl;
+					all_match = false;
+				}
+			}
+		}
+
+		for ( const auto& variant : day.variants )
+		{
+			double variant_seconds = {};
+			uint32_t mismatches = {};
+			for ( size_t i = 0; i < inputs.size(); ++i )
+			{
+				//a variant that throws on an input the reference handles counts as a mismatch rather than ending the check
+				try
+				{
+					const Result result = variant.solve( inputs[i] );
+					variant_seconds += result.execution_time;
+					if ( result.part_1 != expected[i].first || result.part_2 != expected[i].second )
+					{
+						std::cout << "  " << variant.name << " differs on " << input_names[i] << ": expected " << expected[i].first << ", " << expected[i].second
+							<< " got " << result.part_1 << ", " << result.part_2 << std::endl;
+						++mismatches;
+					}
+				}
+				catch ( const std::exception& e )
+				{
+					std::cout << "  " << variant.name << " threw on " << input_names[i] << ": " << e.what() << std::endl;
+					++mismatches;
+				}
+			}
+			const double speedup = (variant_seconds > 0.0) ? reference_seconds / variant_seconds : 0.0;
+			std::cout << std::left << std::setw( 8 ) << day.label << std::setw( 24 ) << variant.name << std::right
+				<< std::setw( 3 ) << inputs.size() << " inputs " << std::setw( 12 ) << variant_seconds << "s "
+				<< std::fixed << std::setprecision( 2 ) << std::setw( 8 ) << speedup << "x " << std::defaultfloat << std::setprecision( 6 )
+				<< ((mismatches == 0) ? "ok" : "MISMATCH") << std::endl;
+			all_match = all_match && mismatches == 0;
+		}
+	}
+	//the day 6 answers can't reach the races where the vector kernels leave their double precision path, those are checked directly
+	if ( options.day.empty() || options.day == "day_06" )
+	{
+		all_match = check_race_kernels() && all_match;
+	}
+	return all_match;
+}
+
+static void print_scaling_row( const std::string& label, const uint32_t threads, const double seconds, const double single_thread_seconds, const size_t input_bytes )
+{
+	const double speedup = (seconds > 0.0) ? single_thread_seconds / seconds : 0.0;
+	const double efficiency = speedup / threads;
+	const double gigabytes_per_second = (seconds > 0.0) ? static_cast<double>(input_bytes) / seconds / 1e9 : 0.0;
+	std::cout << std::left << std::setw( 8 ) << label << std::right << std::setw( 8 ) << threads << std::setw( 14 ) << seconds
+		<< std::fixed << std::setprecision( 3 ) << std::setw( 10 ) << gigabytes_per_second
+		<< std::setprecision( 2 ) << std::setw( 10 ) << speedup << "x" << std::setw( 11 ) << 100.0 * efficiency << "%";
+	//Karp-Flatt serial fraction e = (1/S - 1/p) / (1 - 1/p), not defined for a single thread
+	if ( threads > 1 && speedup > 0.0 )
+	{
+		const double p = static_cast<double>(threads);
+		std::cout << std::setprecision( 3 ) << std::setw( 12 ) << (1.0 / speedup - 1.0 / p) / (1.0 - 1.0 / p);
+	}
+	else
+	{
+		std::cout << std::setw( 12 ) << "-";
+	}
+	std::cout << std::defaultfloat << std::setprecision( 6 ) << std::endl;
+}
+
+bool solvers::scaling_sweep( const Scaling_Options& options )
+{
+	std::vector<uint32_t> thread_counts = {};
+	for ( uint32_t threads = 1; threads < options.max_threads; threads *= 2 )
+	{
+		thread_counts.push_back( threads );
+	}
+	thread_counts.push_back( std::max( options.max_threads, 1u ) );
+
+	const uint32_t previous_thread_count = parallel::thread_count();
+	std::vector<double> suite_seconds( thread_counts.size(), 0.0 );
+	size_t suite_bytes = {};
+	std::cout << std::left << std::setw( 8 ) << "Day" << std::right << std::setw( 8 ) << "Threads" << std::setw( 14 ) << "Seconds"
+		<< std::setw( 10 ) << "GB/s" << std::setw( 11 ) << "Speedup" << std::setw( 12 ) << "Efficiency" << std::setw( 12 ) << "Karp-Flatt" << std::endl;
+	for ( const auto& day : s_registry )
+	{
+		if ( !options.day.empty() && options.day != day.label )
+		{
+			continue;
+		}
+		const std::string input_file = options.input_directory + "/" + day.label + ".txt";
+		std::string input = {};
+		if ( !read_input_file( input_file, input ) )
+		{
+			std::cout << "Unable to read " << input_file << std::endl;
+			parallel::set_thread_count( previous_thread_count );
+			return false;
+		}
+		suite_bytes += input.size();
+		std::vector<double> seconds = {};
+		for ( size_t t = 0; t < thread_counts.size(); ++t )
+		{
+			parallel::set_thread_count( thread_counts[t] );
+			double fastest = std::numeric_limits<double>::max();
+			for ( uint32_t r = 0; r < std::max( options.repetitions, 1u ); ++r )
+			{
+				fastest = std::min( fastest, day.solve( input ).execution_time );
+			}
+			seconds.push_back( fastest );
+			suite_seconds[t] += fastest;
+		}
+		for ( size_t t = 0; t < thread_counts.size(); ++t )
+		{
+			print_scaling_row( day.label, thread_counts[t], seconds[t], seconds[0], input.size() );
+		}
+	}
+	if ( options.day.empty() )
+	{
+		for ( size_t t = 0; t < thread_counts.size(); ++t )
+		{
+			print_scaling_row( "suite", thread_counts[t], suite_seconds[t], suite_seconds[0], suite_bytes );
+		}
+	}
+	parallel::set_thread_count( previous_thread_count );
+	return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Result;
+
+/*
+ * Registry of the solver implementations for each day. solve is the shipped aoc::day_XX entry point
+ * that the runners call. The reference is the same entry point, or the references::day_XX solver it
+ * replaced where the entry point has been rewritten, and is only used by check(). Optimised variants
+ * are registered alongside it and are expected to produce identical answers. check() runs every
+ * implementation over the sample inputs and over seeded generated inputs, diffs the answers against
+ * the reference and reports the speedup.
+ */
+namespace solvers
+{
+	using Solver = Result( * )( std::string_view input );
+	using Generator = std::string( * )( uint32_t seed );
+
+	struct Variant
+	{
+		std::string name;
+		Solver solve;
+	};
+
+	struct Day
+	{
+		std::string label;					/** < day_XX */
+		Solver solve;						/** < aoc::day_XX, run by the scaling sweep, --watch and --batch */
+		Solver reference;					/** < what check() compares solve and the variants against */
+		std::vector<Variant> variants;
+		std::vector<std::string> samples;	/** < sample files that hold a complete puzzle for both parts */
+		Generator generate;					/** < nullptr where a random input can't satisfy the puzzle's hidden structure */
+		bool embedded_parse = false;		/** < parses the embedded input at compile time, before its line ends could be normalised */
+	};
+
+	extern const std::vector<Day>& registry();
+
+	//read a whole puzzle input file into contents, returns false if it could not be opened
+	extern bool read_input_file( const std::string& input_file, std::string& contents );
+
+	struct Check_Options
+	{
+		std::string sample_directory;
+		std::string scratch_directory;	/** < generated inputs are written here so that a failing one can be reproduced */
+		uint32_t seeds;					/** < number of generated inputs per day */
+		std::string day;				/** < only check this day_XX, empty for all */
+	};
+
+	//run every registered implementation and print any differences, returns false if an answer differed
+	extern bool check( const Check_Options& options );
+
+	struct Scaling_Options
+	{
+		std::string input_directory;
+		uint32_t max_threads;	/** < sweep 1, 2, 4 ... up to and including this many threads */
+		uint32_t repetitions;	/** < the fastest of this many runs is used for each thread count */
+		std::string day;		/** < only sweep this day_XX, empty for the whole suite */
+	};
+
+	//rerun the shipped solvers at increasing thread counts and print throughput, speedup, parallel efficiency and the Karp-Flatt
+	//serial fraction for each day and for the suite as a whole, returns false if an input could not be read
+	extern bool scaling_sweep( const Scaling_Options& options );
+}
+
+//the solvers that aoc::day_XX replaced when it was rewritten, kept so the rewrite can be checked against them
+namespace references
+{
+	extern Result day_01( std::string_view input );
+	extern Result day_02( std::string_view input );
+	extern Result day_03( std::string_view input );
+	extern Result day_04( std::string_view input );
+	extern Result day_05( std::string_view input );
+	extern Result day_06( std::string_view input );
+}
+
+namespace generators
+{
+	extern std::string day_01( uint32_t seed );
+	extern std::string day_02( uint32_t seed );
+	extern std::string day_03( uint32_t seed );
+	extern std::string day_04( uint32_t seed );
+	extern std::string day_05( uint32_t seed );
+	extern std::string day_06( uint32_t seed );
+	extern std::string day_07( uint32_t seed );
+	extern std::string day_09( uint32_t seed );
+	extern std::string day_11( uint32_t seed );
+	extern std::string day_12( uint32_t seed );
+	extern std::string day_14( uint32_t seed );
+	extern std::string day_15( uint32_t seed );
+	extern std::string day_16( uint32_t seed );
+	extern std::string day_17( uint32_t seed );
+	extern std::string day_18( uint32_t seed );
+	extern std::string day_19( uint32_t seed );
+}
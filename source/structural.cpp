@@ -0,0 +1,70 @@
+#include "cpu_dispatch.h"
+#include "structural.h"
+
+#include <bit>
+
+structural::Index structural::build( const std::string_view text )
+{
+	Index index = {};
+	index.text = text;
+	const size_t words = (text.size() + 63) / 64;
+	std::vector<uint64_t> newline_bits( words, 0 );
+	index.structural_bits.resize( words, 0 );
+	cpu::kernels().classify_structure( text.data(), text.size(), newline_bits.data(), index.structural_bits.data() );
+
+	//a line starts at 0 and after every newline, a newline at the very end doesn't start another line
+	if ( !text.empty() )
+	{
+		index.line_starts.push_back( 0 );
+	}
+	for ( size_t w = 0; w < words; ++w )
+	{
+		for ( uint64_t bits = newline_bits[w]; bits != 0; bits &= bits - 1 )
+		{
+			const size_t start = w * 64 + std::countr_zero( bits ) + 1;
+			if ( start < text.size() )
+			{
+				index.line_starts.push_back( start );
+			}
+		}
+	}
+	return index;
+}
+
+std::string_view structural::line( const Index& index, const size_t line_number )
+{
+	const size_t start = index.line_starts[line_number];
+	size_t end = (line_number + 1 < index.line_starts.size()) ? index.line_starts[line_number + 1] - 1 : index.text.size();
+	if ( line_number + 1 == index.line_starts.size() && end > start && index.text[end - 1] == '\n' )
+	{
+		--end;
+	}
+	return index.text.substr( start, end - start );
+}
+
+size_t structural::next_structural( const Index& index, const size_t from, const size_t to )
+{
+	for ( size_t w = from / 64; w * 64 < to; ++w )
+	{
+		uint64_t bits = index.structural_bits[w];
+		//drop anything before from in the first word
+		if ( w == from / 64 )
+		{
+			bits &= ~0ULL << (from % 64);
+		}
+		if ( bits != 0 )
+		{
+			const size_t position = w * 64 + std::countr_zero( bits );
+			return (position < to) ? position : to;
+		}
+	}
+	return to;
+}
+
+size_t structural::find_in_line( const Index& index, const size_t line_number, const size_t from )
+{
+	const size_t start = index.line_starts[line_number];
+	const size_t end = start + line( index, line_number ).size();
+	const size_t position = next_structural( index, start + from, end );
+	return (position == end) ? std::string_view::npos : position - start;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+ * Structural index of a puzzle input, built once with the vector classify kernel. It holds the
+ * start of every line and a bitmap of the field separators the parsers look for (':' '|' '(' '{' '>')
+ * so a parser can walk the lines and jump straight to its fields instead of rescanning each line.
+ */
+namespace structural
+{
+	struct Index
+	{
+		std::string_view text;
+		std::vector<size_t> line_starts;		/** < offset of the first character of each line, the same lines std::getline would produce */
+		std::vector<uint64_t> structural_bits;	/** < bit i % 64 of word i / 64 is set if text[i] is a structural character */
+	};
+
+	extern Index build( std::string_view text );
+
+	inline size_t line_count( const Index& index )
+	{
+		return index.line_starts.size();
+	}
+
+	//the line without its '\n'
+	extern std::string_view line( const Index& index, size_t line_number );
+
+	//offset of the first structural character in [from, to), to if there is none
+	extern size_t next_structural( const Index& index, size_t from, size_t to );
+
+	//offset of the first structural character in a line relative to the start of the line, std::string_view::npos if there is none
+	extern size_t find_in_line( const Index& index, size_t line_number, size_t from = 0 );
+}
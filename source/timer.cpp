@@ -1,9 +1,10 @@
 #include "timer.h"
 #include <chrono>
 
-static std::chrono::time_point<std::chrono::steady_clock> s_start_time;
-static std::chrono::time_point<std::chrono::steady_clock> s_end_time;
-static bool s_timer_active = false;
+//one timer per thread so days can be solved concurrently by code embedding the library
+static thread_local std::chrono::time_point<std::chrono::steady_clock> s_start_time;
+static thread_local std::chrono::time_point<std::chrono::steady_clock> s_end_time;
+static thread_local bool s_timer_active = false;
 
 void timer::start()
 {
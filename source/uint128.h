@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/*
+ * Unsigned 128 bit integer for the counts that can outgrow 64 bits. MSVC has no built in 128 bit
+ * type so the value is kept as two words with the carries handled by hand, only the operations the
+ * solvers need are provided.
+ */
+namespace wide
+{
+	struct Uint128
+	{
+		uint64_t low = {};
+		uint64_t high = {};
+
+		constexpr Uint128() = default;
+
+		//a 64 bit value widens with a zero high word, so Count{ 1 } reads the same for either count type
+		constexpr Uint128( const uint64_t low_word, const uint64_t high_word = 0 ) : low( low_word ), high( high_word ) {}
+
+		constexpr Uint128& operator+=( const Uint128 other )
+		{
+			const uint64_t sum = low + other.low;
+			high += other.high + ((sum < low) ? 1 : 0);
+			low = sum;
+			return *this;
+		}
+
+		constexpr Uint128& operator-=( const Uint128 other )
+		{
+			const uint64_t difference = low - other.low;
+			high -= other.high + ((difference > low) ? 1 : 0);
+			low = difference;
+			return *this;
+		}
+
+		constexpr bool operator==( const Uint128& other ) const = default;
+
+		constexpr bool operator<( const Uint128& other ) const
+		{
+			return (high != other.high) ? high < other.high : low < other.low;
+		}
+	};
+
+	constexpr Uint128 operator+( Uint128 a, const Uint128 b )
+	{
+		return a += b;
+	}
+
+	constexpr Uint128 operator-( Uint128 a, const Uint128 b )
+	{
+		return a -= b;
+	}
+
+	//full product of two 64 bit values
+	inline Uint128 multiply( const uint64_t a, const uint64_t b )
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		uint64_t high = {};
+		const uint64_t low = _umul128( a, b, &high );
+		return { low, high };
+#else
+		const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+		return { static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64) };
+#endif
+	}
+
+	inline double to_double( const Uint128 value )
+	{
+		return static_cast<double>(value.high) * 18446744073709551616.0 + static_cast<double>(value.low);
+	}
+
+	//largest root with root * root <= value
+	inline uint64_t isqrt( const Uint128 value )
+	{
+		//a double holds 53 bits of the value so its root is within about 2^10 of the true one, a Newton step on the exact
+		//remainder brings that to within a couple and the last steps are settled on exact squares
+		const double estimate = std::sqrt( to_double( value ) );
+		uint64_t root = (estimate >= 18446744073709551615.0) ? UINT64_MAX : static_cast<uint64_t>(estimate);
+		if ( root > 0 )
+		{
+			const Uint128 square = multiply( root, root );
+			const double step = to_double( (value < square) ? square - value : value - square ) / (2.0 * static_cast<double>(root));
+			const uint64_t correction = (step >= 18446744073709551615.0) ? UINT64_MAX : static_cast<uint64_t>(step);
+			root = (value < square) ? root - std::min( root, correction ) : root + std::min( UINT64_MAX - root, correction );
+		}
+		while ( value < multiply( root, root ) )
+		{
+			--root;
+		}
+		while ( root < UINT64_MAX && !(value < multiply( root + 1, root + 1 )) )
+		{
+			++root;
+		}
+		return root;
+	}
+
+	//decimal digits of the value
+	inline std::string to_string( Uint128 value )
+	{
+		//divide by 10^9 a 32 bit limb at a time, each remainder is the next nine digits
+		constexpr uint64_t divisor = 1000000000;
+		std::string digits = {};
+		do
+		{
+			uint32_t limbs[4] = { static_cast<uint32_t>(value.high >> 32), static_cast<uint32_t>(value.high), static_cast<uint32_t>(value.low >> 32), static_cast<uint32_t>(value.low) };
+			uint64_t remainder = {};
+			for ( auto& limb : limbs )
+			{
+				const uint64_t current = (remainder << 32) | limb;
+				limb = static_cast<uint32_t>(current / divisor);
+				remainder = current % divisor;
+			}
+			value = { (static_cast<uint64_t>(limbs[2]) << 32) | limbs[3], (static_cast<uint64_t>(limbs[0]) << 32) | limbs[1] };
+			std::string chunk = std::to_string( remainder );
+			if ( value.low != 0 || value.high != 0 )
+			{
+				chunk.insert( 0, 9 - chunk.size(), '0' );
+			}
+			digits.insert( 0, chunk );
+		} while ( value.low != 0 || value.high != 0 );
+		return digits;
+	}
+}
@@ -0,0 +1,221 @@
+#include "result.h"
+#include "solvers.h"
+#include "watch.h"
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <set>
+
+#if defined(__linux__)
+#define AOC_WATCH_SUPPORTED 1
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#define AOC_WATCH_SUPPORTED 0
+#endif
+
+#if AOC_WATCH_SUPPORTED
+namespace watch
+{
+	using Clock = std::chrono::steady_clock;
+
+	//input and last answer held for each day between changes
+	struct Watched_Day
+	{
+		std::string input;
+		std::optional<Result> result;
+	};
+
+	static double milliseconds_between( const Clock::time_point begin, const Clock::time_point end )
+	{
+		return std::chrono::duration<double, std::milli>( end - begin ).count();
+	}
+
+	static void print_results( const Watch_Options& options, const std::vector<Watched_Day>& days )
+	{
+		std::vector<Result> results = {};
+		for ( const auto& day : days )
+		{
+			if ( day.result.has_value() )
+			{
+				results.push_back( *day.result );
+			}
+		}
+		options.print_table( results );
+	}
+
+	//a half written input can make a solver throw, keep the previous answer when that happens
+	static bool solve_day( const solvers::Day& day, Watched_Day& watched )
+	{
+		try
+		{
+			watched.result.emplace( day.solve( watched.input ) );
+			return true;
+		}
+		catch ( const std::exception& e )
+		{
+			std::cout << day.label << " threw: " << e.what() << ", keeping the previous answer" << std::endl;
+			return false;
+		}
+	}
+
+	//re-read a day's input, returns false if it could not be read or has not changed
+	static bool reload_day( const Watch_Options& options, const solvers::Day& day, Watched_Day& watched )
+	{
+		const std::string input_file = (std::filesystem::path( options.input_directory ) / (day.label + ".txt")).string();
+		std::string input = {};
+		if ( !solvers::read_input_file( input_file, input ) || input == watched.input )
+		{
+			return false;
+		}
+		watched.input = std::move( input );
+		return true;
+	}
+
+	bool is_supported()
+	{
+		return true;
+	}
+
+	//block until something in the directory changes then collect the days whose input was written,
+	//returns false if the watch was lost
+	static bool wait_for_changes( const int watch_fd, const uint32_t settle_milliseconds, std::set<size_t>& changed, Clock::time_point& first_event )
+	{
+		const std::vector<solvers::Day>& registry = solvers::registry();
+		alignas(inotify_event) char buffer[4096];
+		pollfd poll_fd = { watch_fd, POLLIN, 0 };
+		int timeout = -1;
+		for ( ;; )
+		{
+			const int ready = poll( &poll_fd, 1, timeout );
+			if ( ready < 0 && errno == EINTR )
+			{
+				continue;
+			}
+			if ( ready == 0 )
+			{
+				//quiet for the settle time
+				return true;
+			}
+			const ssize_t length = (ready > 0) ? read( watch_fd, buffer, sizeof( buffer ) ) : -1;
+			if ( length <= 0 )
+			{
+				return false;
+			}
+			if ( timeout < 0 )
+			{
+				first_event = Clock::now();
+				timeout = static_cast<int>(settle_milliseconds);
+			}
+			for ( ssize_t offset = 0; offset < length; )
+			{
+				const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += static_cast<ssize_t>(sizeof( inotify_event ) + event->len);
+				if ( (event->mask & IN_IGNORED) != 0 )
+				{
+					//the directory itself was removed or unmounted
+					return false;
+				}
+				if ( event->len == 0 )
+				{
+					continue;
+				}
+				const std::string name = event->name;
+				for ( size_t i = 0; i < registry.size(); ++i )
+				{
+					if ( name == registry[i].label + ".txt" )
+					{
+						changed.insert( i );
+					}
+				}
+			}
+		}
+	}
+
+	bool run( const Watch_Options& options )
+	{
+		const std::vector<solvers::Day>& registry = solvers::registry();
+		std::vector<Watched_Day> days( registry.size() );
+		for ( size_t i = 0; i < registry.size(); ++i )
+		{
+			//missing inputs are picked up once they are written
+			if ( reload_day( options, registry[i], days[i] ) )
+			{
+				solve_day( registry[i], days[i] );
+			}
+		}
+		print_results( options, days );
+
+		const int watch_fd = inotify_init1( IN_CLOEXEC );
+		if ( watch_fd < 0 )
+		{
+			return false;
+		}
+		//writes in place finish with a close, editors that save through a temporary file finish with a rename into the directory
+		if ( inotify_add_watch( watch_fd, options.input_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0 )
+		{
+			close( watch_fd );
+			return false;
+		}
+		std::cout << "Watching " << options.input_directory << " for changes" << std::endl;
+
+		for ( ;; )
+		{
+			std::set<size_t> changed = {};
+			Clock::time_point first_event = {};
+			if ( !wait_for_changes( watch_fd, options.settle_milliseconds, changed, first_event ) )
+			{
+				close( watch_fd );
+				return false;
+			}
+
+			//only days whose contents actually differ are solved again, touching a file or saving it unchanged is ignored
+			struct Resolve_Time
+			{
+				size_t day;
+				double total_milliseconds;		/** < from the first file event until the new answer */
+				double solve_milliseconds;		/** < the solver's own parse + solve time */
+			};
+			std::vector<Resolve_Time> resolve_times = {};
+			for ( const size_t i : changed )
+			{
+				if ( reload_day( options, registry[i], days[i] ) && solve_day( registry[i], days[i] ) )
+				{
+					resolve_times.push_back( { i, milliseconds_between( first_event, Clock::now() ), 1000.0 * days[i].result->execution_time } );
+				}
+			}
+			if ( resolve_times.empty() )
+			{
+				continue;
+			}
+			print_results( options, days );
+			for ( const auto& time : resolve_times )
+			{
+				std::cout << registry[time.day].label << " re-solved " << std::fixed << std::setprecision( 3 ) << time.total_milliseconds
+					<< "ms after the change (solver " << time.solve_milliseconds << "ms)" << std::defaultfloat << std::setprecision( 6 ) << std::endl;
+			}
+			std::cout << "Table updated " << std::fixed << std::setprecision( 3 ) << milliseconds_between( first_event, Clock::now() )
+				<< "ms after the change" << std::defaultfloat << std::setprecision( 6 ) << std::endl;
+		}
+	}
+}
+#else
+namespace watch
+{
+	bool is_supported()
+	{
+		return false;
+	}
+
+	bool run( const Watch_Options& )
+	{
+		return false;
+	}
+}
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Result;
+
+/*
+ * Watch mode for tuning inputs and solvers. Every day is solved once, then the input directory is
+ * watched (inotify) and only the day whose file changed is re-read and re-solved. Inputs and
+ * answers of the other days are kept in memory so the table is reprinted straight away along
+ * with how long the change took to go from the file event to a new answer.
+ * Only available on Linux.
+ */
+namespace watch
+{
+	struct Watch_Options
+	{
+		std::string input_directory;
+		uint32_t settle_milliseconds;	/** < events arriving this soon after the first one are handled together, editors often write a file in several steps */
+		void (*print_table)( const std::vector<Result>& results );
+	};
+
+	//is watching supported on this platform
+	extern bool is_supported();
+
+	//solve every day then re-solve days as their inputs change, only returns if the directory can't be watched (false)
+	extern bool run( const Watch_Options& options );
+}
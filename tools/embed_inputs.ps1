@@ -0,0 +1,48 @@
+# Writes the puzzle inputs out as constexpr char arrays for the AocEmbedInputs build, run by aoc_2023_lib.vcxproj
+# before anything is compiled. Missing inputs get an empty array so the build still succeeds.
+param(
+	[Parameter(Mandatory = $true)][string]$InputDirectory,
+	[Parameter(Mandatory = $true)][string]$Output
+)
+
+$builder = [System.Text.StringBuilder]::new()
+[void]$builder.AppendLine('//generated from the puzzle inputs by tools/embed_inputs.ps1, do not edit')
+[void]$builder.AppendLine('#pragma once')
+[void]$builder.AppendLine('#include <cstddef>')
+[void]$builder.AppendLine('')
+[void]$builder.AppendLine('namespace embedded::data')
+[void]$builder.AppendLine('{')
+for ($day = 1; $day -le 20; ++$day)
+{
+	$label = 'day_{0:D2}' -f $day
+	$path = Join-Path $InputDirectory "$label.txt"
+	$bytes = if (Test-Path $path) { [System.IO.File]::ReadAllBytes($path) } else { [byte[]]@() }
+	# a checkout with autocrlf has "\r\n" line ends, the '\r' is dropped the same way buffer::normalise_line_ends drops it
+	# so that the constexpr parsers only ever see '\n'
+	# char may be signed so bytes over 127 are written as negative values, a trailing zero keeps the array from being empty
+	$values = [System.Collections.Generic.List[string]]::new()
+	for ($i = 0; $i -lt $bytes.Length; ++$i)
+	{
+		$byte = $bytes[$i]
+		if ($byte -eq 13 -and ($i + 1 -eq $bytes.Length -or $bytes[$i + 1] -eq 10))
+		{
+			continue
+		}
+		$values.Add([string]$(if ($byte -gt 127) { $byte - 256 } else { $byte }))
+	}
+	$size = $values.Count
+	$values.Add('0')
+	[void]$builder.AppendLine("`tinline constexpr char $label[] = {")
+	for ($i = 0; $i -lt $values.Count; $i += 32)
+	{
+		$count = [Math]::Min(32, $values.Count - $i)
+		[void]$builder.AppendLine("`t`t" + ($values.GetRange($i, $count) -join ', ') + ',')
+	}
+	[void]$builder.AppendLine("`t};")
+	[void]$builder.AppendLine("`tinline constexpr size_t ${label}_size = $size;")
+	[void]$builder.AppendLine('')
+}
+[void]$builder.AppendLine('}')
+
+New-Item -ItemType Directory -Force -Path (Split-Path -Parent $Output) | Out-Null
+[System.IO.File]::WriteAllText($Output, $builder.ToString())